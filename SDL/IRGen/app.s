@@ -1,219 +1,201 @@
-entry:
-    sub rsp 16384
+func appInit
+    sub rsp 26220
 
-    add rsp 3964
+    add rsp 18024
+    store rsp 2049
+    sub rsp 18024
+
+    add rsp 4352
     store rsp 1
-    sub rsp 3964
+    sub rsp 4352
 
-    add rsp 3968
+    add rsp 4356
     store rsp 1
-    sub rsp 3968
+    sub rsp 4356
 
-    add rsp 4216
+    add rsp 4612
     store rsp 1
-    sub rsp 4216
+    sub rsp 4612
 
-    add rsp 4220
+    add rsp 4616
     store rsp 1
-    sub rsp 4220
+    sub rsp 4616
 
-    add rsp 4476
+    add rsp 4880
     store rsp 1
-    sub rsp 4476
+    sub rsp 4880
 
-endless_loop:
-    xor r7 r7
+    add rsp 17964
+    store rsp 1
+    sub rsp 17964
+
+    add rsp 17996
+    store rsp 1
+    sub rsp 17996
+
+    add rsp 18000
+    store rsp 1
+    sub rsp 18000
+    exit
+
+func appStep
+    asgn r7 1
 
 compute_alive_loop_y:
-    xor r6 r6
+    asgn r6 1
 
 compute_alive_loop_x:
-    xor r0 r0
-
     asgn r5 r7
-    mul r5 64
+    mul r5 66
     add r5 r6
+    mul r5 4
+    add r5 rsp
 
-    sub r5 64
-    cmplt r5 0
-    cjmp skip_top_neighbor
-    cmpgt r5 8191
-    cjmp skip_top_neighbor
-
-    asgn r4 r5
-    mul r4 4
-    add r4 rsp
-    load r4 r4
-    cmpe r4 0
-    cjmp skip_top_neighbor
-    add r0 1
+    sub r5 268
+    load r0 r5
 
-skip_top_neighbor:
-    add r5 1
-    cmplt r5 0
-    cjmp skip_top_right_neighbor
-    cmpgt r5 8191
-    cjmp skip_top_right_neighbor
+    add r5 4
+    load r4 r5
+    add r0 r4
 
-    asgn r4 r5
-    mul r4 4
-    add r4 rsp
-    load r4 r4
-    cmpe r4 0
-    cjmp skip_top_right_neighbor
-    add r0 1
+    add r5 4
+    load r4 r5
+    add r0 r4
 
-skip_top_right_neighbor:
-    add r5 64
-    cmplt r5 0
-    cjmp skip_right_neighbor
-    cmpgt r5 8191
-    cjmp skip_right_neighbor
+    add r5 264
+    load r4 r5
+    add r0 r4
 
-    asgn r4 r5
-    mul r4 4
-    add r4 rsp
-    load r4 r4
-    cmpe r4 0
-    cjmp skip_right_neighbor
-    add r0 1
+    add r5 264
+    load r4 r5
+    add r0 r4
 
-skip_right_neighbor:
-    add r5 64
-    cmplt r5 0
-    cjmp skip_bottom_right_neighbor
-    cmpgt r5 8191
-    cjmp skip_bottom_right_neighbor
+    sub r5 4
+    load r4 r5
+    add r0 r4
 
-    asgn r4 r5
-    mul r4 4
-    add r4 rsp
-    load r4 r4
-    cmpe r4 0
-    cjmp skip_bottom_right_neighbor
-    add r0 1
+    sub r5 4
+    load r4 r5
+    add r0 r4
 
-skip_bottom_right_neighbor:
-    sub r5 1
-    cmplt r5 0
-    cjmp skip_bottom_neighbor
-    cmpgt r5 8191
-    cjmp skip_bottom_neighbor
+    sub r5 264
+    load r4 r5
+    add r0 r4
 
-    asgn r4 r5
+    add r5 4
+    load r4 r5
+    asgn r3 r4
+    mul r4 9
+    add r4 r0
     mul r4 4
     add r4 rsp
+    add r4 17952
     load r4 r4
-    cmpe r4 0
-    cjmp skip_bottom_neighbor
-    add r0 1
 
-skip_bottom_neighbor:
-    sub r5 1
-    cmplt r5 0
-    cjmp skip_bottom_left_neighbor
-    cmpgt r5 8191
-    cjmp skip_bottom_left_neighbor
-
-    asgn r4 r5
-    mul r4 4
-    add r4 rsp
-    load r4 r4
-    cmpe r4 0
-    cjmp skip_bottom_left_neighbor
-    add r0 1
+    asgn r2 r4
+    sub r2 r3
+    cmpe r2 0
+    cjmp store_next_cell
+
+    asgn r2 rsp
+    add r2 18024
+    load r1 r2
+    add r1 1
+    store r2 r1
+    cmpgt r1 2048
+    cjmp store_next_cell
+    mul r1 4
+    add r1 r2
+    asgn r0 r5
+    sub r0 rsp
+    store r1 r0
+
+store_next_cell:
+    add r5 8976
+    store r5 r4
 
-skip_bottom_left_neighbor:
-    sub r5 64
-    cmplt r5 0
-    cjmp skip_left_neighbor
-    cmpgt r5 8191
-    cjmp skip_left_neighbor
+    add r6 1
+    cmpne r6 65
+    cjmp compute_alive_loop_x
 
-    asgn r4 r5
-    mul r4 4
-    add r4 rsp
-    load r4 r4
-    cmpe r4 0
-    cjmp skip_left_neighbor
-    add r0 1
+    add r7 1
+    cmpne r7 33
+    cjmp compute_alive_loop_y
 
-skip_left_neighbor:
-    sub r5 64
-    cmplt r5 0
-    cjmp skip_top_left_neighbor
-    cmpgt r5 8191
-    cjmp skip_top_left_neighbor
+    asgn r5 rsp
 
-    asgn r4 r5
-    mul r4 4
-    add r4 rsp
-    load r4 r4
-    cmpe r4 0
-    cjmp skip_top_left_neighbor
-    add r0 1
+assign_current_loop:
+    add r5 8976
+    load r4 r5
+    sub r5 8976
+    store r5 r4
 
-skip_top_left_neighbor:
-    add r5 65
+    add r5 4
     asgn r4 r5
-    mul r4 4
-    add r4 rsp
-    load r4 r4
+    sub r4 rsp
+    cmpne r4 8976
+    cjmp assign_current_loop
+    exit
+
+func appRender
+    asgn r5 rsp
+    add r5 18024
+    load r1 r5
+    cmpgt r1 2048
+    cjmp draw_all_cells
+    xor r2 r2
+
+draw_dirty_loop:
+    asgn r4 r1
+    sub r4 r2
     cmpe r4 0
-    cjmp dead_cell_logic
-
-    cmpe r0 2
-    cjmp mark_cell_as_alive
-
-    cmpe r0 3
-    cjmp mark_cell_as_alive
+    cjmp render_done
+
+    asgn r3 r2
+    mul r3 4
+    add r3 r5
+    add r3 4
+    load r0 r3
+
+    asgn r7 r0
+    div r7 264
+    asgn r4 r7
+    mul r4 264
+    asgn r6 r0
+    sub r6 r4
+    div r6 4
+    sub r6 1
+    sub r7 1
 
-    jmp mark_cell_as_dead
-
-dead_cell_logic:
-    cmpe r0 3
-    cjmp mark_cell_as_alive
-
-mark_cell_as_dead:
-    asgn r4 r5
-    mul r4 4
-    add r4 8192
-    add r4 rsp
-    store r4 0
-    jmp iterate_compute_alive_x
-
-mark_cell_as_alive:
-    asgn r4 r5
-    mul r4 4
-    add r4 8192
-    add r4 rsp
-    store r4 1
+    add r0 rsp
+    load r0 r0
+    cmpe r0 0
+    cjmp draw_dirty_dead_cell
+    asgn r0 0
+    sub r0 1
+    putpx r6 r7 r0
+    jmp iterate_dirty
 
-iterate_compute_alive_x:
-    add r6 1
-    cmpne r6 64
-    cjmp compute_alive_loop_x
+draw_dirty_dead_cell:
+    putpx r6 r7 0
 
-    add r7 1
-    cmpne r7 32
-    cjmp compute_alive_loop_y
+iterate_dirty:
+    add r2 1
+    jmp draw_dirty_loop
 
+draw_all_cells:
     xor r7 r7
 
 putpx_loop_y:
     xor r6 r6
 
 putpx_loop_x:
-    asgn r3 r7
-    asgn r0 r6
-
-    div r0 8
-    div r3 8
-
-    mul r3 64
-    add r3 r0
+    asgn r0 r7
+    add r0 1
+    mul r0 66
+    add r0 r6
+    add r0 1
 
-    asgn r0 r3
     mul r0 4
     add r0 rsp
     load r0 r0
@@ -229,39 +211,14 @@ draw_dead_cell:
     putpx r6 r7 0
 
 iterate_putpx_x:
-    add r6 1
-    cmpne r6 512
-    cjmp putpx_loop_x
-
-    add r7 1
-    cmpne r7 256
-    cjmp putpx_loop_y
-
-    flush
-
-    xor r7 r7
-
-assign_current_loop_y:
-    xor r6 r6
-
-assign_current_loop_x:
-    asgn r5 r7
-    mul r5 64
-    add r5 r6
-
-    mul r5 4
-    add r5 rsp
-    add r5 8192
-    load r4 r5
-    sub r5 8192
-    store r5 r4
-
     add r6 1
     cmpne r6 64
-    cjmp assign_current_loop_x
+    cjmp putpx_loop_x
 
     add r7 1
     cmpne r7 32
-    cjmp assign_current_loop_y
+    cjmp putpx_loop_y
 
-    jmp endless_loop
+render_done:
+    store r5 0
+    exit
@@ -334,12 +334,10 @@ int main(int argc, char* argv[])
 
     isaBuilder.asmToIr(argv[1], false);
 
-    Function* mainFunc = module->getFunction("main");
-
     outs() << "\n#[LLVM IR]:\n";
     module->print(outs(), nullptr);
     outs() << "\n";
-    bool verif = verifyFunction(*mainFunc, &outs());
+    bool verif = verifyModule(*module, &outs());
     outs() << "[VERIFICATION] " << (!verif ? "OK\n\n" : "FAIL\n\n");
 
     outs() << "\n#[Running code]\n";
@@ -363,9 +361,9 @@ int main(int argc, char* argv[])
     );
     ee->finalizeObject();
 
-    simInit();
+    simInitLogical(SIM_X_SIZE / SIM_ZOOM, SIM_Y_SIZE / SIM_ZOOM);
 
-    ee->runFunction(mainFunc, {});
+    runAsmApp(ee);
     outs() << "#[Code was run]\n";
 
     simExit();
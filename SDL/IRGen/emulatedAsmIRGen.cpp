@@ -172,12 +172,10 @@ int main(int argc, char* argv[])
 
     isaBuilder.asmToIr(argv[1], true);
 
-    Function* mainFunc = module->getFunction("main");
-
     outs() << "\n#[LLVM IR]:\n";
     module->print(outs(), nullptr);
     outs() << "\n";
-    bool verif = verifyFunction(*mainFunc, &outs());
+    bool verif = verifyModule(*module, &outs());
     outs() << "[VERIFICATION] " << (!verif ? "OK\n\n" : "FAIL\n\n");
 
     outs() << "\n#[Running code]\n";
@@ -191,10 +189,10 @@ int main(int argc, char* argv[])
     ee->addGlobalMapping(module->getNamedGlobal("flagFile"), (void*) &FLAG_FILE);
     ee->finalizeObject();
 
-    simInit();
+    simInitLogical(SIM_X_SIZE / SIM_ZOOM, SIM_Y_SIZE / SIM_ZOOM);
 
     REG_FILE[REG_FILE_SIZE - 1] = MEMORY_FILE_SIZE;
-    ee->runFunction(mainFunc, {});
+    runAsmApp(ee);
     outs() << "#[Code was run]\n";
 
     simExit();
@@ -1,3 +1,4 @@
+#include "../sim.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
@@ -247,8 +248,18 @@ class IsaBuilder
             );
         }
 
+        // Each `func <name>` line starts a void function that the host calls by name,
+        // code before the first one belongs to main
         FunctionType* funcType = FunctionType::get(builder.getVoidTy(), false);
-        Function* mainFunc = Function::Create(funcType, Function::ExternalLinkage, "main", module);
+        Function* function = nullptr;
+        auto currentFunction = [&]()
+        {
+            if (!function)
+            {
+                function = Function::Create(funcType, Function::ExternalLinkage, "main", module);
+            }
+            return function;
+        };
 
         std::string name;
         std::string arg;
@@ -268,10 +279,17 @@ class IsaBuilder
 
             std::string name = split.front();
 
+            if (split.size() == 2 && name == "func")
+            {
+                function =
+                    Function::Create(funcType, Function::ExternalLinkage, split[1], module);
+                continue;
+            }
+
             if (split.size() == 1 && name.back() == ':')
             {
                 name = name.substr(0, name.size() - 1);
-                labels[name] = BasicBlock::Create(context, name, mainFunc);
+                labels[name] = BasicBlock::Create(context, name, currentFunction());
                 continue;
             }
 
@@ -280,7 +298,7 @@ class IsaBuilder
                 std::string falseDestinationName =
                     "falseDestination" + std::to_string(conditionalJumpsCount);
                 BasicBlock* falseDestination =
-                    BasicBlock::Create(context, falseDestinationName, mainFunc);
+                    BasicBlock::Create(context, falseDestinationName, currentFunction());
                 falseDestinations.push_back(falseDestination);
                 ++conditionalJumpsCount;
                 continue;
@@ -302,6 +320,20 @@ class IsaBuilder
 
             std::string name = split.front();
 
+            if (split.size() == 2 && name == "func")
+            {
+                returnIfUnterminated(builder);
+                Function* function = module->getFunction(split[1]);
+                BasicBlock* entry = BasicBlock::Create(
+                    context,
+                    "entry",
+                    function,
+                    function->empty() ? nullptr : &function->front()
+                );
+                builder.SetInsertPoint(entry);
+                continue;
+            }
+
             if (split.size() == 1 && name.back() == ':')
             {
                 name = name.substr(0, name.size() - 1);
@@ -363,6 +395,7 @@ class IsaBuilder
                 outs() << "Invalid args for instruction " << name << ", ignoring it\n";
             }
         }
+        returnIfUnterminated(builder);
     }
 
     void prepareExecutionEngine(ExecutionEngine* ee)
@@ -387,6 +420,16 @@ class IsaBuilder
     std::unordered_map<std::string, void*> emulatedFunctions;
     std::unordered_map<std::string, std::vector<InstructionFlavor>> instructions;
 
+    // Running off the end of a function returns from it
+    void returnIfUnterminated(IRBuilder<>& builder)
+    {
+        BasicBlock* insertBlock = builder.GetInsertBlock();
+        if (insertBlock && !insertBlock->getTerminator())
+        {
+            builder.CreateRetVoid();
+        }
+    }
+
     template <typename... Args>
     std::string getFunctionName(std::string const& mnemonic)
     {
@@ -450,3 +493,38 @@ class IsaBuilder
         return result;
     }
 };
+
+// Entry points of a program written as `func appInit`, `func appStep` and `func appRender`.
+// SARCH cannot pass arguments, so appStep advances a single generation per call
+void (*AsmAppStep)() = nullptr;
+void (*AsmAppRender)() = nullptr;
+
+void stepAsmApp(int generations)
+{
+    for (int i = 0; i < generations; ++i)
+    {
+        AsmAppStep();
+    }
+}
+
+// The SARCH grid is the size of the framebuffer, so the viewport never moves
+void renderAsmApp(int, int)
+{
+    AsmAppRender();
+}
+
+// Drives the app through simRun, or runs main once for programs without the app entry points
+void runAsmApp(ExecutionEngine* ee)
+{
+    auto init = reinterpret_cast<void (*)()>(ee->getFunctionAddress("appInit"));
+    AsmAppStep = reinterpret_cast<void (*)()>(ee->getFunctionAddress("appStep"));
+    AsmAppRender = reinterpret_cast<void (*)()>(ee->getFunctionAddress("appRender"));
+    if (!init || !AsmAppStep || !AsmAppRender)
+    {
+        reinterpret_cast<void (*)()>(ee->getFunctionAddress("main"))();
+        return;
+    }
+
+    init();
+    simRun(stepAsmApp, renderAsmApp);
+}
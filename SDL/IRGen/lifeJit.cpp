@@ -0,0 +1,717 @@
+#include "../lifeStep.h"
+#include "../pattern.h"
+#include "../rule.h"
+#include "../sim.h"
+
+#include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/MCJIT.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#if __has_include(<llvm/TargetParser/Host.h>)
+#include <llvm/TargetParser/Host.h>
+#else
+#include <llvm/Support/Host.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Runs the app.c scene with step and render kernels JIT-compiled for the actual grid size,
+// rule and zoom: every size is a constant, rows are unrolled to their exact length and
+// cells are processed in vectors as wide as the host CPU supports.
+// Usage: lifeJit.out                 run the app
+//        lifeJit.out --bench [width height generations zoom]
+//                                    compare the kernels with the static app.c loops
+
+using namespace llvm;
+
+namespace
+{
+// Rows up to this many vectors long are unrolled completely,
+// longer ones are stepped by a loop over blocks of BLOCK_CHUNKS vectors
+constexpr int MAX_UNROLLED_CHUNKS = 128;
+constexpr int BLOCK_CHUNKS = 8;
+
+// Everything the kernels are specialised for. Grids have the ghost border of app.c,
+// so rows are width + 2 cells apart and cell (x, y) is at (y + 1) * stride + x + 1
+struct KernelShape
+{
+    int width;
+    int height;
+    Rule rule;
+    // Cells shown in the logical framebuffer, the window size divided by the zoom
+    int viewWidth;
+    int viewHeight;
+    // Cells per vector
+    int vectorWidth;
+
+    std::int64_t stride() const
+    {
+        return std::int64_t(width) + 2;
+    }
+};
+
+using StepKernel = void (*)(std::uint8_t const* current, std::uint8_t* next);
+// Draws the viewWidth x viewHeight cells starting at cells as ARGB pixels
+using RenderKernel = void (*)(std::uint8_t const* cells, std::uint32_t* pixels);
+
+struct LifeKernels
+{
+    std::unique_ptr<LLVMContext> context;
+    std::unique_ptr<ExecutionEngine> engine;
+    StepKernel step;
+    RenderKernel render;
+    double compileMilliseconds;
+};
+
+int hostVectorWidth()
+{
+    char const* cells = std::getenv("LIFE_JIT_VECTOR");
+    if (cells)
+    {
+        return std::max(std::atoi(cells), 1);
+    }
+    if (__builtin_cpu_supports("avx512bw"))
+    {
+        return 64;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return 32;
+    }
+    return 16;
+}
+
+bool sameRule(Rule a, Rule b)
+{
+    return a.birth == b.birth && a.survival == b.survival;
+}
+
+class KernelGenerator
+{
+  public:
+    KernelGenerator(Module* module, KernelShape const& shape)
+        : module(module)
+        , context(module->getContext())
+        , builder(context)
+        , shape(shape)
+    {
+    }
+
+    void generateStep()
+    {
+        Function* function = createKernel("lifeStep");
+        Value* current = function->getArg(0);
+        Value* next = function->getArg(1);
+
+        BasicBlock* entry = BasicBlock::Create(context, "", function);
+        BasicBlock* rows = BasicBlock::Create(context, "rows", function);
+        BasicBlock* exit = BasicBlock::Create(context, "exit", function);
+        builder.SetInsertPoint(entry);
+        builder.CreateBr(rows);
+
+        builder.SetInsertPoint(rows);
+        PHINode* y = builder.CreatePHI(builder.getInt64Ty(), 2);
+        Value* offset = builder.CreateMul(y, builder.getInt64(shape.stride()), "", true, true);
+        Value* row = builder.CreateInBoundsGEP(builder.getInt8Ty(), current, offset);
+        Value* above = builder.CreateInBoundsGEP(
+            builder.getInt8Ty(), row, builder.getInt64(-shape.stride())
+        );
+        Value* below =
+            builder.CreateInBoundsGEP(builder.getInt8Ty(), row, builder.getInt64(shape.stride()));
+        Value* output = builder.CreateInBoundsGEP(builder.getInt8Ty(), next, offset);
+        generateRow(function, above, row, below, output);
+
+        Value* nextY = builder.CreateAdd(y, builder.getInt64(1), "", true, true);
+        builder.CreateCondBr(
+            builder.CreateICmpEQ(nextY, builder.getInt64(shape.height + 1)), exit, rows
+        );
+        y->addIncoming(builder.getInt64(1), entry);
+        y->addIncoming(nextY, builder.GetInsertBlock());
+
+        builder.SetInsertPoint(exit);
+        builder.CreateRetVoid();
+    }
+
+    void generateRender()
+    {
+        Function* function = createKernel("lifeRender");
+        Value* cells = function->getArg(0);
+        Value* pixels = function->getArg(1);
+
+        BasicBlock* entry = BasicBlock::Create(context, "", function);
+        BasicBlock* rows = BasicBlock::Create(context, "rows", function);
+        BasicBlock* exit = BasicBlock::Create(context, "exit", function);
+        builder.SetInsertPoint(entry);
+        builder.CreateBr(rows);
+
+        builder.SetInsertPoint(rows);
+        PHINode* y = builder.CreatePHI(builder.getInt64Ty(), 2);
+        Value* cellRow = builder.CreateInBoundsGEP(
+            builder.getInt8Ty(),
+            cells,
+            builder.CreateMul(y, builder.getInt64(shape.stride()), "", true, true)
+        );
+        Value* pixelRow = builder.CreateInBoundsGEP(
+            builder.getInt32Ty(),
+            pixels,
+            builder.CreateMul(y, builder.getInt64(shape.viewWidth), "", true, true)
+        );
+        forEachChunk(
+            shape.viewWidth,
+            0,
+            [&](int x, Type* cellType)
+            {
+                Value* alive = builder.CreateICmpNE(
+                    loadCells(cellRow, x, cellType), ConstantInt::get(cellType, 0)
+                );
+                Type* pixelType = builder.getInt32Ty();
+                if (cellType->isVectorTy())
+                {
+                    pixelType = FixedVectorType::get(pixelType, chunkCount(cellType));
+                }
+                Value* color = builder.CreateSelect(
+                    alive,
+                    ConstantInt::get(pixelType, 0xFFFFFFFF),
+                    ConstantInt::get(pixelType, 0xFF000000)
+                );
+                builder.CreateAlignedStore(
+                    color,
+                    builder.CreateInBoundsGEP(builder.getInt32Ty(), pixelRow, builder.getInt64(x)),
+                    Align(4)
+                );
+            }
+        );
+
+        Value* nextY = builder.CreateAdd(y, builder.getInt64(1), "", true, true);
+        builder.CreateCondBr(
+            builder.CreateICmpEQ(nextY, builder.getInt64(shape.viewHeight)), exit, rows
+        );
+        y->addIncoming(builder.getInt64(0), entry);
+        y->addIncoming(nextY, rows);
+
+        builder.SetInsertPoint(exit);
+        builder.CreateRetVoid();
+    }
+
+  private:
+    Module* module;
+    LLVMContext& context;
+    IRBuilder<> builder;
+    KernelShape shape;
+
+    Function* createKernel(char const* name)
+    {
+        FunctionType* type = FunctionType::get(
+            builder.getVoidTy(), {builder.getPtrTy(), builder.getPtrTy()}, false
+        );
+        Function* function = Function::Create(type, Function::ExternalLinkage, name, module);
+        function->addParamAttr(0, Attribute::NoAlias);
+        function->addParamAttr(1, Attribute::NoAlias);
+        function->addFnAttr(Attribute::NoUnwind);
+        return function;
+    }
+
+    static int chunkCount(Type* type)
+    {
+        return cast<FixedVectorType>(type)->getNumElements();
+    }
+
+    // Calls body for every vector of cells in a row starting at column first, then for the cells
+    // left over, with the cell type (a vector or a single i8) and the column as a constant
+    template <class Body>
+    void forEachChunk(int length, int first, Body&& body)
+    {
+        int chunks = length / shape.vectorWidth;
+        for (int i = 0; i < chunks; ++i)
+        {
+            body(first + i * shape.vectorWidth, chunkType());
+        }
+        for (int x = chunks * shape.vectorWidth; x < length; ++x)
+        {
+            body(first + x, builder.getInt8Ty());
+        }
+    }
+
+    // A vector of cells, or a single cell when vectors are one cell wide
+    Type* chunkType()
+    {
+        if (shape.vectorWidth == 1)
+        {
+            return builder.getInt8Ty();
+        }
+        return FixedVectorType::get(builder.getInt8Ty(), shape.vectorWidth);
+    }
+
+    Value* loadCells(Value* base, Value* x, Type* type)
+    {
+        return builder.CreateAlignedLoad(
+            type, builder.CreateInBoundsGEP(builder.getInt8Ty(), base, x), Align(1)
+        );
+    }
+
+    Value* loadCells(Value* base, std::int64_t x, Type* type)
+    {
+        return loadCells(base, builder.getInt64(x), type);
+    }
+
+    // The rule folded into comparisons against the counts it uses.
+    // Counts in both masks do not need the cell itself
+    Value* nextState(Value* self, Value* count, Type* type)
+    {
+        if (sameRule(shape.rule, Rule{1u << 3, 1u << 2 | 1u << 3}))
+        {
+            // Alive with 3 neighbours, or alive already with 2
+            Value* alive = builder.CreateICmpEQ(
+                builder.CreateOr(count, self), ConstantInt::get(type, 3)
+            );
+            return builder.CreateZExt(alive, type);
+        }
+
+        Value* alive = builder.CreateICmpNE(self, ConstantInt::get(type, 0));
+        Value* dead = builder.CreateNot(alive);
+        Value* result = nullptr;
+        for (int n = 0; n <= 8; ++n)
+        {
+            bool born = shape.rule.birth >> n & 1;
+            bool survives = shape.rule.survival >> n & 1;
+            if (!born && !survives)
+            {
+                continue;
+            }
+            Value* term = builder.CreateICmpEQ(count, ConstantInt::get(type, n));
+            if (!born || !survives)
+            {
+                term = builder.CreateAnd(term, born ? dead : alive);
+            }
+            result = result ? builder.CreateOr(result, term) : term;
+        }
+        return result ? builder.CreateZExt(result, type) : ConstantInt::get(type, 0);
+    }
+
+    void stepCells(Value* above, Value* row, Value* below, Value* output, Value* x, Type* type)
+    {
+        auto neighbour = [&](Value* base, int dx)
+        { return loadCells(base, builder.CreateAdd(x, builder.getInt64(dx)), type); };
+
+        Value* count = neighbour(above, -1);
+        count = builder.CreateAdd(count, neighbour(above, 0));
+        count = builder.CreateAdd(count, neighbour(above, 1));
+        count = builder.CreateAdd(count, neighbour(row, 1));
+        count = builder.CreateAdd(count, neighbour(below, 1));
+        count = builder.CreateAdd(count, neighbour(below, 0));
+        count = builder.CreateAdd(count, neighbour(below, -1));
+        count = builder.CreateAdd(count, neighbour(row, -1));
+        Value* self = loadCells(row, x, type);
+        builder.CreateAlignedStore(
+            nextState(self, count, type),
+            builder.CreateInBoundsGEP(builder.getInt8Ty(), output, x),
+            Align(1)
+        );
+    }
+
+    // Columns 1 to width of one row. Short rows are straight-line code,
+    // long ones loop over blocks and finish the remainder straight-line
+    void generateRow(Function* function, Value* above, Value* row, Value* below, Value* output)
+    {
+        int chunks = shape.width / shape.vectorWidth;
+        int first = 1;
+        if (chunks > MAX_UNROLLED_CHUNKS)
+        {
+            int blocks = chunks / BLOCK_CHUNKS;
+            int blockCells = BLOCK_CHUNKS * shape.vectorWidth;
+
+            BasicBlock* preheader = builder.GetInsertBlock();
+            BasicBlock* loop = BasicBlock::Create(context, "blocks", function);
+            BasicBlock* after = BasicBlock::Create(context, "rest", function);
+            builder.CreateBr(loop);
+            builder.SetInsertPoint(loop);
+            PHINode* x = builder.CreatePHI(builder.getInt64Ty(), 2);
+            for (int i = 0; i < BLOCK_CHUNKS; ++i)
+            {
+                Value* chunkX = builder.CreateAdd(x, builder.getInt64(i * shape.vectorWidth));
+                stepCells(above, row, below, output, chunkX, chunkType());
+            }
+            Value* nextX = builder.CreateAdd(x, builder.getInt64(blockCells), "", true, true);
+            builder.CreateCondBr(
+                builder.CreateICmpEQ(nextX, builder.getInt64(1 + blocks * blockCells)), after, loop
+            );
+            x->addIncoming(builder.getInt64(1), preheader);
+            x->addIncoming(nextX, loop);
+            builder.SetInsertPoint(after);
+            first += blocks * blockCells;
+        }
+
+        forEachChunk(
+            shape.width + 1 - first,
+            first,
+            [&](int x, Type* cellType)
+            { stepCells(above, row, below, output, builder.getInt64(x), cellType); }
+        );
+    }
+};
+
+std::unique_ptr<Module> generateKernels(LLVMContext& context, KernelShape const& shape)
+{
+    auto module = std::make_unique<Module>("lifeKernels", context);
+    KernelGenerator generator(module.get(), shape);
+    generator.generateStep();
+    generator.generateRender();
+    assert(!verifyModule(*module, &errs()) && "Generated kernels are malformed");
+    return module;
+}
+
+void optimize(Module& module, TargetMachine* targetMachine)
+{
+    LoopAnalysisManager loopAnalyses;
+    FunctionAnalysisManager functionAnalyses;
+    CGSCCAnalysisManager sccAnalyses;
+    ModuleAnalysisManager moduleAnalyses;
+    PassBuilder passBuilder(targetMachine);
+    passBuilder.registerModuleAnalyses(moduleAnalyses);
+    passBuilder.registerCGSCCAnalyses(sccAnalyses);
+    passBuilder.registerFunctionAnalyses(functionAnalyses);
+    passBuilder.registerLoopAnalyses(loopAnalyses);
+    passBuilder.crossRegisterProxies(loopAnalyses, functionAnalyses, sccAnalyses, moduleAnalyses);
+    passBuilder.buildPerModuleDefaultPipeline(OptimizationLevel::O3).run(module, moduleAnalyses);
+}
+
+LifeKernels compileKernels(KernelShape const& shape)
+{
+    InitializeNativeTarget();
+    InitializeNativeTargetAsmPrinter();
+
+    auto begin = std::chrono::steady_clock::now();
+    LifeKernels kernels;
+    kernels.context = std::make_unique<LLVMContext>();
+    std::unique_ptr<Module> module = generateKernels(*kernels.context, shape);
+    Module* moduleView = module.get();
+
+    std::string error;
+    EngineBuilder engineBuilder(std::move(module));
+    engineBuilder.setEngineKind(EngineKind::JIT).setErrorStr(&error).setMCPU(sys::getHostCPUName());
+    TargetMachine* targetMachine = engineBuilder.selectTarget();
+    assert(targetMachine && "No target for the host CPU");
+    moduleView->setDataLayout(targetMachine->createDataLayout());
+    moduleView->setTargetTriple(targetMachine->getTargetTriple().str());
+    optimize(*moduleView, targetMachine);
+
+    kernels.engine.reset(engineBuilder.create(targetMachine));
+    if (!kernels.engine)
+    {
+        errs() << "Failed to create the JIT: " << error << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+    kernels.engine->finalizeObject();
+    kernels.step = reinterpret_cast<StepKernel>(kernels.engine->getFunctionAddress("lifeStep"));
+    kernels.render =
+        reinterpret_cast<RenderKernel>(kernels.engine->getFunctionAddress("lifeRender"));
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    kernels.compileMilliseconds = elapsed.count();
+    return kernels;
+}
+
+int zoomFromEnvironment()
+{
+    char const* zoom = std::getenv("LIFE_JIT_ZOOM");
+    int value = zoom ? std::atoi(zoom) : SIM_ZOOM;
+    if (value <= 0 || SIM_X_SIZE % value != 0 || SIM_Y_SIZE % value != 0)
+    {
+        std::fprintf(stderr, "[jit] LIFE_JIT_ZOOM must divide %dx%d\n", SIM_X_SIZE, SIM_Y_SIZE);
+        std::exit(EXIT_FAILURE);
+    }
+    return value;
+}
+
+// The drawing loop of app.c, writing into memory instead of calling simPutPixel
+void staticRender(KernelShape const& shape, std::uint8_t const* cells, std::uint32_t* pixels)
+{
+    for (int y = 0; y < shape.viewHeight; ++y)
+    {
+        for (int x = 0; x < shape.viewWidth; ++x)
+        {
+            std::uint8_t alive = cells[y * shape.stride() + x];
+            pixels[y * shape.viewWidth + x] = alive ? 0xFFFFFFFF : 0xFF000000;
+        }
+    }
+}
+
+void fillNextState(Rule rule, unsigned char next_state[2 * 9])
+{
+    for (int n = 0; n <= 8; ++n)
+    {
+        next_state[n] = rule.birth >> n & 1;
+        next_state[9 + n] = rule.survival >> n & 1;
+    }
+}
+
+KernelShape shapeFor(int width, int height, int zoom)
+{
+    KernelShape shape;
+    shape.width = width;
+    shape.height = height;
+    shape.rule = ruleFromEnvironment();
+    shape.viewWidth = std::min(SIM_X_SIZE / zoom, width);
+    shape.viewHeight = std::min(SIM_Y_SIZE / zoom, height);
+    shape.vectorWidth = hostVectorWidth();
+    return shape;
+}
+
+// State of the app between the calls from simRun
+struct JitApp
+{
+    KernelShape shape;
+    LifeKernels kernels;
+    std::uint8_t* currentlyAlive;
+    std::uint8_t* nextAlive;
+    int* pixels;
+};
+
+JitApp App;
+
+void initApp()
+{
+    int zoom = zoomFromEnvironment();
+    simInitLogical(SIM_X_SIZE / zoom, SIM_Y_SIZE / zoom);
+
+    int width, height;
+    simGridSize(&width, &height);
+    App.shape = shapeFor(width, height, zoom);
+    App.kernels = compileKernels(App.shape);
+    std::fprintf(
+        stderr,
+        "[jit] Compiled kernels for %dx%d, %d-cell vectors in %.1f ms\n",
+        width,
+        height,
+        App.shape.vectorWidth,
+        App.kernels.compileMilliseconds
+    );
+
+    std::size_t stride = App.shape.stride();
+    std::size_t cells = stride * (height + 2);
+    auto* currently_alive = static_cast<std::uint8_t*>(simAlloc(cells));
+    App.currentlyAlive = currently_alive;
+    App.nextAlive = static_cast<std::uint8_t*>(simAlloc(cells));
+    App.pixels = static_cast<int*>(
+        simAlloc(std::size_t(App.shape.viewWidth) * App.shape.viewHeight * sizeof(int))
+    );
+
+    // The grid layout matches app.c, so either app restores checkpoints of the other
+    if (simCheckpointGrid(&App.currentlyAlive, cells))
+    {
+        return;
+    }
+
+    if (!patternLoadFromEnvironment(currently_alive + stride + 1, stride, width, height))
+    {
+#ifdef SOUP_DENSITY
+        auto* soup = static_cast<int*>(simAlloc(width * sizeof(int)));
+        for (int y = 1; y <= height; ++y)
+        {
+            simRandFill(soup, width);
+            for (int x = 1; x <= width; ++x)
+            {
+                currently_alive[y * stride + x] = soup[x - 1] % 100 < SOUP_DENSITY;
+            }
+        }
+#else
+        std::size_t center = height / 2 * stride + width / 2;
+        currently_alive[center + 1] = 1;
+        currently_alive[center + 2] = 1;
+        currently_alive[center + stride] = 1;
+        currently_alive[center + stride + 1] = 1;
+        currently_alive[center + 2 * stride + 1] = 1;
+#endif
+    }
+}
+
+void stepApp(int generations)
+{
+    std::size_t stride = App.shape.stride();
+    int width = App.shape.width;
+    int height = App.shape.height;
+    for (int i = 0; i < generations; ++i)
+    {
+#ifdef TOROIDAL
+        // Ghost cells mirror the opposite edge, as in app.c
+        std::uint8_t* cells = App.currentlyAlive;
+        for (int y = 1; y <= height; ++y)
+        {
+            cells[y * stride] = cells[y * stride + width];
+            cells[y * stride + width + 1] = cells[y * stride + 1];
+        }
+        std::memcpy(cells, cells + height * stride, stride);
+        std::memcpy(cells + (height + 1) * stride, cells + stride, stride);
+#endif
+        App.kernels.step(App.currentlyAlive, App.nextAlive);
+        std::swap(App.currentlyAlive, App.nextAlive);
+    }
+}
+
+void renderApp(int x, int y)
+{
+    App.kernels.render(
+        App.currentlyAlive + (y + 1) * App.shape.stride() + x + 1,
+        reinterpret_cast<std::uint32_t*>(App.pixels)
+    );
+    simBlit(0, 0, App.shape.viewWidth, App.shape.viewHeight, App.pixels, App.shape.viewWidth);
+}
+
+template <class Step>
+double secondsFor(int generations, Step&& step)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < generations; ++i)
+    {
+        step();
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - begin;
+    return seconds.count();
+}
+
+int benchmark(int argc, char** argv)
+{
+    int width = argc > 0 ? std::atoi(argv[0]) : 1024;
+    int height = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int generations = argc > 2 ? std::atoi(argv[2]) : 100;
+    int zoom = argc > 3 ? std::atoi(argv[3]) : SIM_ZOOM;
+    if (width <= 0 || height <= 0 || generations <= 0 || zoom <= 0)
+    {
+        std::fprintf(stderr, "Usage: lifeJit.out --bench [width height generations zoom]\n");
+        return EXIT_FAILURE;
+    }
+
+    KernelShape shape = shapeFor(width, height, zoom);
+    LifeKernels kernels = compileKernels(shape);
+    unsigned char next_state[2 * 9];
+    fillNextState(shape.rule, next_state);
+
+    std::size_t cells = shape.stride() * (height + 2);
+    std::vector<std::uint8_t> start(cells);
+    std::mt19937_64 random(width * 31 + height);
+    for (int y = 1; y <= height; ++y)
+    {
+        for (int x = 1; x <= width; ++x)
+        {
+            start[y * shape.stride() + x] = random() % 100 < 30;
+        }
+    }
+
+    std::vector<std::uint8_t> staticCurrent = start, staticNext(cells);
+    std::vector<std::uint8_t> jitCurrent = start, jitNext(cells);
+    double staticSeconds = secondsFor(
+        generations,
+        [&]
+        {
+            // The generation loop of app.c, compiled ahead of time
+            lifeStep(
+                staticCurrent.data(),
+                staticNext.data(),
+                shape.stride(),
+                width,
+                height,
+                next_state
+            );
+            std::swap(staticCurrent, staticNext);
+        }
+    );
+    double jitSeconds = secondsFor(
+        generations,
+        [&]
+        {
+            kernels.step(jitCurrent.data(), jitNext.data());
+            std::swap(jitCurrent, jitNext);
+        }
+    );
+    bool sameGrid = staticCurrent == jitCurrent;
+
+    std::size_t pixelCount = std::size_t(shape.viewWidth) * shape.viewHeight;
+    std::vector<std::uint32_t> staticPixels(pixelCount), jitPixels(pixelCount);
+    std::uint8_t const* viewport = staticCurrent.data() + shape.stride() + 1;
+    int frames = std::max(1, generations * 10);
+    double staticRenderSeconds =
+        secondsFor(frames, [&] { staticRender(shape, viewport, staticPixels.data()); });
+    double jitRenderSeconds =
+        secondsFor(frames, [&] { kernels.render(viewport, jitPixels.data()); });
+    bool samePixels = staticPixels == jitPixels;
+
+    std::printf(
+        "%dx%d, %d generations, %dx%d viewport, %d-cell vectors, compiled in %.1f ms\n",
+        width,
+        height,
+        generations,
+        shape.viewWidth,
+        shape.viewHeight,
+        shape.vectorWidth,
+        kernels.compileMilliseconds
+    );
+    std::printf(
+        "%-8s %-8s %8s %14s %10s %9s\n",
+        "kernel",
+        "build",
+        "correct",
+        "calls/s",
+        "cells/ns",
+        "speedup"
+    );
+    auto report = [](
+                      char const* kernel,
+                      char const* build,
+                      bool correct,
+                      double seconds,
+                      int calls,
+                      double cellsPerCall,
+                      double reference
+                  )
+    {
+        std::printf(
+            "%-8s %-8s %8s %14.1f %10.3f %8.2fx\n",
+            kernel,
+            build,
+            correct ? "yes" : "NO",
+            calls / seconds,
+            calls * cellsPerCall / seconds * 1e-9,
+            reference / seconds
+        );
+    };
+    double gridCells = double(width) * height;
+    report("step", "static", true, staticSeconds, generations, gridCells, staticSeconds);
+    report("step", "jit", sameGrid, jitSeconds, generations, gridCells, staticSeconds);
+    report("render", "static", true, staticRenderSeconds, frames, pixelCount, staticRenderSeconds);
+    report("render", "jit", samePixels, jitRenderSeconds, frames, pixelCount, staticRenderSeconds);
+    return sameGrid && samePixels ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+    {
+        return benchmark(argc - 2, argv + 2);
+    }
+    if (argc > 1)
+    {
+        errs() << "Usage: lifeJit [--bench [width height generations zoom]]\n";
+        return EXIT_FAILURE;
+    }
+
+    initApp();
+    simRun(stepApp, renderApp);
+    simExit();
+    return 0;
+}
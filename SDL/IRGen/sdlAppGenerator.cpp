@@ -19,7 +19,6 @@ namespace
 struct GeneratedIR
 {
     Module* module;
-    Function* appFunction;
 };
 
 GeneratedIR generateIR(LLVMContext&);
@@ -67,17 +66,6 @@ GeneratedIR generateIR(LLVMContext& context)
     FunctionCallee simPutPixelFunction =
         module->getOrInsertFunction("simPutPixel", simPutPixelFunctionType);
 
-    FunctionType* simFlushFunctionType = FunctionType::get(builder.getVoidTy(), {}, false);
-    FunctionCallee simFlushFunction = module->getOrInsertFunction("simFlush", simFlushFunctionType);
-
-    FunctionType* memsetFunctionType = FunctionType::get(
-        builder.getVoidTy(),
-        {builder.getPtrTy(), builder.getInt8Ty(), builder.getInt64Ty(), builder.getInt1Ty()},
-        false
-    );
-    FunctionCallee memsetFunction =
-        module->getOrInsertFunction("llvm.memset.p0.i64", memsetFunctionType);
-
     FunctionType* memcpyFunctionType = FunctionType::get(
         builder.getVoidTy(),
         {builder.getPtrTy(), builder.getPtrTy(), builder.getInt64Ty(), builder.getInt1Ty()},
@@ -86,337 +74,343 @@ GeneratedIR generateIR(LLVMContext& context)
     FunctionCallee memcpyFunction =
         module->getOrInsertFunction("llvm.memcpy.p0.p0.i64", memcpyFunctionType);
 
-    FunctionType* appFunctionType = FunctionType::get(builder.getVoidTy(), false);
-    Function* appFunction =
-        Function::Create(appFunctionType, Function::ExternalLinkage, "app", module);
-
-    BasicBlock* bb0 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb8 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb15 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb17 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb19 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb23 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb29 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb30 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb32 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb38 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb47 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb54 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb55 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb56 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb64 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb71 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb84 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb92 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb93 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb96 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb102 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb118 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb122 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb123 = BasicBlock::Create(context, "", appFunction);
-    BasicBlock* bb126 = BasicBlock::Create(context, "", appFunction);
-
-    builder.SetInsertPoint(bb0);
+    // 32 x 64 cells surrounded by a one-cell ghost border, kept between the calls of the driver
     Type* arrayElementType = builder.getInt32Ty();
-    ArrayType* arrayType = ArrayType::get(ArrayType::get(arrayElementType, 64), 32);
-    Value* val1 = builder.CreateAlloca(arrayType);
-    Value* val2 = builder.CreateAlloca(arrayType);
-    builder.CreateCall(
-        memsetFunction,
-        {val1, builder.getInt8(0), builder.getInt64(8192), builder.getInt1(false)}
-    );
-    builder.CreateCall(
-        memsetFunction,
-        {val2, builder.getInt8(0), builder.getInt64(8192), builder.getInt1(false)}
-    );
-
-    Value* val3 = builder.CreateGEP(
-        arrayType,
-        val1,
-        {builder.getInt64(0), builder.getInt64(15), builder.getInt64(32)},
-        "",
-        true
-    );
-    Value* val4 = builder.CreateGEP(
+    ArrayType* arrayType = ArrayType::get(ArrayType::get(arrayElementType, 66), 34);
+    Value* val1 = new GlobalVariable(
+        *module,
         arrayType,
-        val1,
-        {builder.getInt64(0), builder.getInt64(15), builder.getInt64(33)},
-        "",
-        true
+        false,
+        GlobalValue::PrivateLinkage,
+        ConstantAggregateZero::get(arrayType),
+        "currentlyAlive"
     );
-    Value* val5 = builder.CreateGEP(
+    Value* val2 = new GlobalVariable(
+        *module,
         arrayType,
-        val1,
-        {builder.getInt64(0), builder.getInt64(16), builder.getInt64(31)},
-        "",
-        true
+        false,
+        GlobalValue::PrivateLinkage,
+        ConstantAggregateZero::get(arrayType),
+        "nextAlive"
     );
-    Value* val6 = builder.CreateGEP(
-        arrayType,
-        val1,
-        {builder.getInt64(0), builder.getInt64(16), builder.getInt64(32)},
-        "",
-        true
+
+    // Cells of the viewport that changed since the last frame, as y * 64 + x. A count past
+    // the capacity, as it starts out, makes the next frame redraw every cell
+    ArrayType* dirtyCellsType = ArrayType::get(builder.getInt32Ty(), 2048);
+    Value* dirtyCells = new GlobalVariable(
+        *module,
+        dirtyCellsType,
+        false,
+        GlobalValue::PrivateLinkage,
+        ConstantAggregateZero::get(dirtyCellsType),
+        "dirtyCells"
     );
-    Value* val7 = builder.CreateGEP(
-        arrayType,
-        val1,
-        {builder.getInt64(0), builder.getInt64(17), builder.getInt64(32)},
-        "",
-        true
+    Value* dirtyCount = new GlobalVariable(
+        *module,
+        builder.getInt32Ty(),
+        false,
+        GlobalValue::PrivateLinkage,
+        builder.getInt32(2049),
+        "dirtyCount"
     );
+
+    auto cellPointer = [&](Value* array, Value* y, Value* x)
+    { return builder.CreateGEP(arrayType, array, {builder.getInt64(0), y, x}, "", true); };
+
+    FunctionType* appInitFunctionType = FunctionType::get(builder.getVoidTy(), false);
+    Function* appInitFunction =
+        Function::Create(appInitFunctionType, Function::ExternalLinkage, "appInit", module);
+
+    BasicBlock* bb0 = BasicBlock::Create(context, "", appInitFunction);
+    builder.SetInsertPoint(bb0);
+    Value* val3 = cellPointer(val1, builder.getInt64(16), builder.getInt64(33));
+    Value* val4 = cellPointer(val1, builder.getInt64(16), builder.getInt64(34));
+    Value* val5 = cellPointer(val1, builder.getInt64(17), builder.getInt64(32));
+    Value* val6 = cellPointer(val1, builder.getInt64(17), builder.getInt64(33));
+    Value* val7 = cellPointer(val1, builder.getInt64(18), builder.getInt64(33));
     builder.CreateStore(builder.getInt32(1), val3);
     builder.CreateStore(builder.getInt32(1), val4);
     builder.CreateStore(builder.getInt32(1), val5);
     builder.CreateStore(builder.getInt32(1), val6);
     builder.CreateStore(builder.getInt32(1), val7);
-
-    builder.CreateBr(bb8);
+    builder.CreateRetVoid();
+
+    FunctionType* appStepFunctionType =
+        FunctionType::get(builder.getVoidTy(), {builder.getInt32Ty()}, false);
+    Function* appStepFunction =
+        Function::Create(appStepFunctionType, Function::ExternalLinkage, "appStep", module);
+    Value* generations = appStepFunction->getArg(0);
+
+    BasicBlock* stepEntry = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* bb8 = BasicBlock::Create(context, "", appStepFunction);
+#ifdef TOROIDAL
+    BasicBlock* bb9 = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* bb14 = BasicBlock::Create(context, "", appStepFunction);
+#endif
+    BasicBlock* bb15 = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* bb19 = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* markDirty = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* storeDirty = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* cellEnd = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* bb57 = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* bb122 = BasicBlock::Create(context, "", appStepFunction);
+    BasicBlock* stepExit = BasicBlock::Create(context, "", appStepFunction);
+
+    builder.SetInsertPoint(stepEntry);
+    builder.CreateCondBr(builder.CreateICmpSGT(generations, builder.getInt32(0)), bb8, stepExit);
 
     builder.SetInsertPoint(bb8);
-    PHINode* val9 = builder.CreatePHI(builder.getInt64Ty(), 2);
-    Value* val10 = builder.CreateICmpNE(val9, builder.getInt64(0));
-    Value* val11 = builder.CreateAdd(val9, builder.getInt64(-1), "", false, true);
-    Value* val12 = builder.CreateICmpEQ(val9, builder.getInt64(31));
-    Value* val13 = builder.CreateICmpEQ(val9, builder.getInt64(31));
-    Value* val14 = builder.CreateAdd(val9, builder.getInt64(1), "", true, true);
-    builder.CreateBr(bb19);
+    PHINode* generation = builder.CreatePHI(builder.getInt32Ty(), 2);
+#ifdef TOROIDAL
+    // Ghost columns, then whole ghost rows (corners included) mirror the opposite edge
+    builder.CreateBr(bb9);
+
+    builder.SetInsertPoint(bb9);
+    PHINode* val10 = builder.CreatePHI(builder.getInt64Ty(), 2);
+    Value* val11 = builder.CreateLoad(
+        builder.getInt32Ty(),
+        cellPointer(val1, val10, builder.getInt64(64))
+    );
+    builder.CreateStore(val11, cellPointer(val1, val10, builder.getInt64(0)));
+    Value* val12 = builder.CreateLoad(
+        builder.getInt32Ty(),
+        cellPointer(val1, val10, builder.getInt64(1))
+    );
+    builder.CreateStore(val12, cellPointer(val1, val10, builder.getInt64(65)));
+    Value* val13 = builder.CreateAdd(val10, builder.getInt64(1), "", true, true);
+    builder.CreateCondBr(builder.CreateICmpEQ(val13, builder.getInt64(33)), bb14, bb9);
 
-    builder.SetInsertPoint(bb15);
-    Value* val16 = builder.CreateICmpEQ(val14, builder.getInt64(32));
-    builder.CreateCondBr(val16, bb118, bb17);
+    builder.SetInsertPoint(bb14);
+    builder.CreateCall(
+        memcpyFunction,
+        {cellPointer(val1, builder.getInt64(0), builder.getInt64(0)),
+         cellPointer(val1, builder.getInt64(32), builder.getInt64(0)),
+         builder.getInt64(264),
+         builder.getInt1(false)}
+    );
+    builder.CreateCall(
+        memcpyFunction,
+        {cellPointer(val1, builder.getInt64(33), builder.getInt64(0)),
+         cellPointer(val1, builder.getInt64(1), builder.getInt64(0)),
+         builder.getInt64(264),
+         builder.getInt1(false)}
+    );
+    builder.CreateBr(bb15);
 
-    builder.SetInsertPoint(bb17);
-    PHINode* val18 = builder.CreatePHI(builder.getInt64Ty(), 2);
-    builder.CreateBr(bb8);
+    val10->addIncoming(builder.getInt64(1), bb8);
+    val10->addIncoming(val13, bb9);
+    BasicBlock* generationStart = bb14;
+#else
+    builder.CreateBr(bb15);
+    BasicBlock* generationStart = bb8;
+#endif
 
+    builder.SetInsertPoint(bb15);
+    PHINode* val16 = builder.CreatePHI(builder.getInt64Ty(), 2);
+    Value* val17 = builder.CreateAdd(val16, builder.getInt64(-1), "", true, true);
+    Value* val18 = builder.CreateAdd(val16, builder.getInt64(1), "", true, true);
+    builder.CreateBr(bb19);
+
+    // Straight-line neighbour count, no bounds checks thanks to the ghost border
     builder.SetInsertPoint(bb19);
     PHINode* val20 = builder.CreatePHI(builder.getInt64Ty(), 2);
-    Value* val21 = builder.CreateICmpNE(val20, builder.getInt64(0));
-    Value* val22 = builder.CreateAnd(val10, val21);
-    builder.CreateCondBr(val22, bb23, bb29);
-
-    builder.SetInsertPoint(bb23);
-    Value* val24 = builder.CreateAdd(val20, builder.getInt64(-1), "", false, true);
-    Value* val25 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val11, val24}, "", true);
-    Value* val26 = builder.CreateLoad(builder.getInt32Ty(), val25);
-    Value* val27 = builder.CreateICmpNE(val26, builder.getInt32(0));
-    Value* val28 = builder.CreateZExt(val27, builder.getInt32Ty());
-    builder.CreateBr(bb38);
-
-    builder.SetInsertPoint(bb29);
-    builder.CreateCondBr(val10, bb38, bb30);
-
-    builder.SetInsertPoint(bb30);
-    Value* val31 = builder.CreateICmpEQ(val20, builder.getInt64(63));
-    builder.CreateCondBr(val31, bb64, bb32);
-
-    builder.SetInsertPoint(bb32);
-    Value* val33 = builder.CreateAdd(val20, builder.getInt64(1), "", true, true);
-    Value* val34 = builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val9, val33}, "", true);
-    Value* val35 = builder.CreateLoad(builder.getInt32Ty(), val34);
-    Value* val36 = builder.CreateICmpNE(val35, builder.getInt32(0));
-    Value* val37 = builder.CreateZExt(val36, builder.getInt32Ty());
-    builder.CreateBr(bb71);
-
-    builder.SetInsertPoint(bb38);
-    PHINode* val39 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    Value* val40 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val11, val20}, "", true);
-    Value* val41 = builder.CreateLoad(builder.getInt32Ty(), val40);
-    Value* val42 = builder.CreateICmpNE(val41, builder.getInt32(0));
-    Value* val43 = builder.CreateZExt(val42, builder.getInt32Ty());
-    Value* val44 = builder.CreateAdd(val39, val43, "", true, true);
-    Value* val45 = builder.CreateICmpNE(val20, builder.getInt64(63));
-    Value* val46 = builder.CreateAnd(val10, val45);
-    builder.CreateCondBr(val46, bb47, bb54);
-
-    builder.SetInsertPoint(bb47);
-    Value* val48 = builder.CreateAdd(val20, builder.getInt64(1), "", true, true);
-    Value* val49 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val11, val48}, "", true);
-    Value* val50 = builder.CreateLoad(builder.getInt32Ty(), val49);
-    Value* val51 = builder.CreateICmpNE(val50, builder.getInt32(0));
-    Value* val52 = builder.CreateZExt(val51, builder.getInt32Ty());
-    Value* val53 = builder.CreateAdd(val44, val52, "", true, true);
-    builder.CreateBr(bb56);
-
-    builder.SetInsertPoint(bb54);
-    builder.CreateCondBr(val45, bb56, bb55);
-
-    builder.SetInsertPoint(bb55);
-    builder.CreateCondBr(val12, bb93, bb64);
-
-    builder.SetInsertPoint(bb56);
-    PHINode* val57 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    Value* val58 = builder.CreateAdd(val20, builder.getInt64(1), "", true, true);
-    Value* val59 = builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val9, val58}, "", true);
-    Value* val60 = builder.CreateLoad(builder.getInt32Ty(), val59);
-    Value* val61 = builder.CreateICmpNE(val60, builder.getInt32(0));
-    Value* val62 = builder.CreateZExt(val61, builder.getInt32Ty());
-    Value* val63 = builder.CreateAdd(val57, val62, "", true, true);
-    builder.CreateCondBr(val13, bb92, bb71);
-
-    builder.SetInsertPoint(bb64);
-    PHINode* val65 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    Value* val66 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val14, val20}, "", true);
-    Value* val67 = builder.CreateLoad(builder.getInt32Ty(), val66);
-    Value* val68 = builder.CreateICmpNE(val67, builder.getInt32(0));
-    Value* val69 = builder.CreateZExt(val68, builder.getInt32Ty());
-    Value* val70 = builder.CreateAdd(val65, val69, "", true, true);
-    builder.CreateBr(bb84);
-
-    builder.SetInsertPoint(bb71);
-    PHINode* val72 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    PHINode* val73 = builder.CreatePHI(builder.getInt64Ty(), 2);
-    Value* val74 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val14, val73}, "", true);
-    Value* val75 = builder.CreateLoad(builder.getInt32Ty(), val74);
-    Value* val76 = builder.CreateICmpNE(val75, builder.getInt32(0));
-    Value* val77 = builder.CreateZExt(val76, builder.getInt32Ty());
-    Value* val78 = builder.CreateAdd(val72, val77, "", true, true);
-    Value* val79 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val14, val20}, "", true);
-    Value* val80 = builder.CreateLoad(builder.getInt32Ty(), val79);
-    Value* val81 = builder.CreateICmpNE(val80, builder.getInt32(0));
-    Value* val82 = builder.CreateZExt(val81, builder.getInt32Ty());
-    Value* val83 = builder.CreateAdd(val78, val82, "", true, true);
-    builder.CreateCondBr(val21, bb84, bb102);
-
-    builder.SetInsertPoint(bb84);
-    PHINode* val85 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    Value* val86 = builder.CreateAdd(val20, builder.getInt64(-1), "", false, true);
-    Value* val87 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val14, val86}, "", true);
-    Value* val88 = builder.CreateLoad(builder.getInt32Ty(), val87);
-    Value* val89 = builder.CreateICmpNE(val88, builder.getInt32(0));
-    Value* val90 = builder.CreateZExt(val89, builder.getInt32Ty());
-    Value* val91 = builder.CreateAdd(val85, val90, "", true, true);
-    builder.CreateBr(bb96);
-
-    builder.SetInsertPoint(bb92);
-    builder.CreateCondBr(val21, bb93, bb102);
-
-    builder.SetInsertPoint(bb93);
-    PHINode* val94 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    Value* val95 = builder.CreateAdd(val20, builder.getInt64(-1), "", false, true);
-    builder.CreateBr(bb96);
-
-    builder.SetInsertPoint(bb96);
-    PHINode* val97 = builder.CreatePHI(builder.getInt64Ty(), 2);
-    PHINode* val98 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    Value* val99 = builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val9, val97}, "", true);
-    Value* val100 = builder.CreateLoad(builder.getInt32Ty(), val99);
-    Value* val101 = builder.CreateICmpNE(val100, builder.getInt32(0));
-    builder.CreateBr(bb102);
-
-    builder.SetInsertPoint(bb102);
-    PHINode* val103 = builder.CreatePHI(builder.getInt32Ty(), 3);
-    PHINode* val104 = builder.CreatePHI(builder.getInt1Ty(), 3);
-    Value* val105 = builder.CreateZExt(val104, builder.getInt32Ty());
-    Value* val106 = builder.CreateAdd(val103, val105, "", true, true);
-    Value* val107 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val9, val20}, "", true);
-    Value* val108 = builder.CreateLoad(builder.getInt32Ty(), val107);
-    Value* val109 = builder.CreateICmpEQ(val108, builder.getInt32(0));
-    Value* val110 = builder.CreateICmpEQ(val106, builder.getInt32(3));
-    Value* val111 = builder.CreateAnd(val106, builder.getInt32(-2));
-    Value* val112 = builder.CreateICmpEQ(val111, builder.getInt32(2));
-    Value* val113 = builder.CreateSelect(val109, val110, val112);
-    Value* val114 = builder.CreateZExt(val113, builder.getInt32Ty());
-    Value* val115 =
-        builder.CreateGEP(arrayType, val2, {builder.getInt64(0), val9, val20}, "", true);
-    builder.CreateStore(val114, val115);
-    Value* val116 = builder.CreateAdd(val20, builder.getInt64(1), "", true, true);
-    Value* val117 = builder.CreateICmpEQ(val116, builder.getInt64(64));
-    builder.CreateCondBr(val117, bb15, bb19);
+    Value* val21 = builder.CreateAdd(val20, builder.getInt64(-1), "", true, true);
+    Value* val22 = builder.CreateAdd(val20, builder.getInt64(1), "", true, true);
+    Value* val23 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val17, val21));
+    Value* val24 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val17, val20));
+    Value* val25 = builder.CreateAdd(val23, val24, "", true, true);
+    Value* val26 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val17, val22));
+    Value* val27 = builder.CreateAdd(val25, val26, "", true, true);
+    Value* val28 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val16, val22));
+    Value* val29 = builder.CreateAdd(val27, val28, "", true, true);
+    Value* val30 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val18, val22));
+    Value* val31 = builder.CreateAdd(val29, val30, "", true, true);
+    Value* val32 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val18, val20));
+    Value* val33 = builder.CreateAdd(val31, val32, "", true, true);
+    Value* val34 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val18, val21));
+    Value* val35 = builder.CreateAdd(val33, val34, "", true, true);
+    Value* val36 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val16, val21));
+    Value* val37 = builder.CreateAdd(val35, val36, "", true, true);
+    Value* val38 = builder.CreateLoad(builder.getInt32Ty(), cellPointer(val1, val16, val20));
+    Value* val39 = builder.CreateICmpEQ(val37, builder.getInt32(3));
+    Value* val40 = builder.CreateICmpEQ(val37, builder.getInt32(2));
+    Value* val41 = builder.CreateICmpNE(val38, builder.getInt32(0));
+    Value* val42 = builder.CreateAnd(val40, val41);
+    Value* val43 = builder.CreateOr(val39, val42);
+    Value* val44 = builder.CreateZExt(val43, builder.getInt32Ty());
+    builder.CreateStore(val44, cellPointer(val2, val16, val20));
+    builder.CreateCondBr(builder.CreateICmpNE(val44, val38), markDirty, cellEnd);
+
+    // Cells that changed again since the last frame are listed twice, which only costs a pixel.
+    // The count stops one past the capacity, so it cannot wrap however many generations a frame
+    // steps
+    builder.SetInsertPoint(markDirty);
+    Value* count = builder.CreateLoad(builder.getInt32Ty(), dirtyCount);
+    builder.CreateStore(
+        builder.CreateSelect(
+            builder.CreateICmpULT(count, builder.getInt32(2049)),
+            builder.CreateAdd(count, builder.getInt32(1)),
+            count
+        ),
+        dirtyCount
+    );
+    builder.CreateCondBr(builder.CreateICmpULT(count, builder.getInt32(2048)), storeDirty, cellEnd);
 
-    builder.SetInsertPoint(bb118);
-    PHINode* val119 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    Value* val120 = builder.CreateLShr(val119, builder.getInt32(3));
-    Value* val121 = builder.CreateZExt(val120, builder.getInt64Ty(), "", true);
-    builder.CreateBr(bb126);
+    builder.SetInsertPoint(storeDirty);
+    Value* dirtyCell = builder.CreateAdd(
+        builder.CreateMul(builder.CreateTrunc(val17, builder.getInt32Ty()), builder.getInt32(64)),
+        builder.CreateTrunc(val21, builder.getInt32Ty())
+    );
+    builder.CreateStore(
+        dirtyCell,
+        builder.CreateGEP(
+            dirtyCellsType,
+            dirtyCells,
+            {builder.getInt64(0), builder.CreateZExt(count, builder.getInt64Ty())},
+            "",
+            true
+        )
+    );
+    builder.CreateBr(cellEnd);
+
+    builder.SetInsertPoint(cellEnd);
+    Value* val45 = builder.CreateICmpEQ(val22, builder.getInt64(65));
+    builder.CreateCondBr(val45, bb57, bb19);
+
+    builder.SetInsertPoint(bb57);
+    Value* val58 = builder.CreateICmpEQ(val18, builder.getInt64(33));
+    builder.CreateCondBr(val58, bb122, bb15);
 
     builder.SetInsertPoint(bb122);
-    builder.CreateCall(simFlushFunction);
     builder.CreateCall(
         memcpyFunction,
-        {val1, val2, builder.getInt64(8192), builder.getInt1(false)}
+        {val1, val2, builder.getInt64(8976), builder.getInt1(false)}
     );
-    builder.CreateBr(bb17);
-
-    builder.SetInsertPoint(bb123);
-    Value* val124 = builder.CreateAdd(val119, builder.getInt32(1), "", true, true);
-    Value* val125 = builder.CreateICmpEQ(val124, builder.getInt32(256));
-    builder.CreateCondBr(val125, bb122, bb118);
-
-    builder.SetInsertPoint(bb126);
-    PHINode* val127 = builder.CreatePHI(builder.getInt32Ty(), 2);
-    Value* val128 = builder.CreateLShr(val127, builder.getInt32(3));
-    Value* val129 = builder.CreateZExt(val128, builder.getInt64Ty(), "", true);
-    Value* val130 =
-        builder.CreateGEP(arrayType, val1, {builder.getInt64(0), val121, val129}, "", true);
-    Value* val131 = builder.CreateLoad(builder.getInt32Ty(), val130);
-    Value* val132 = builder.CreateICmpEQ(val131, builder.getInt32(0));
-    Value* val133 = builder.CreateSelect(val132, builder.getInt32(-16777216), builder.getInt32(-1));
-    builder.CreateCall(simPutPixelFunction, {val127, val119, val133});
-    Value* val134 = builder.CreateAdd(val127, builder.getInt32(1), "", true, true);
-    Value* val135 = builder.CreateICmpEQ(val134, builder.getInt32(512));
-    builder.CreateCondBr(val135, bb123, bb126);
-
-    val9->addIncoming(builder.getInt64(0), bb0);
-    val9->addIncoming(val18, bb17);
+    Value* nextGeneration = builder.CreateAdd(generation, builder.getInt32(1), "", true, true);
+    builder.CreateCondBr(builder.CreateICmpEQ(nextGeneration, generations), stepExit, bb8);
 
-    val18->addIncoming(val14, bb15);
-    val18->addIncoming(builder.getInt64(0), bb122);
+    builder.SetInsertPoint(stepExit);
+    builder.CreateRetVoid();
 
-    val20->addIncoming(builder.getInt64(0), bb8);
-    val20->addIncoming(val116, bb102);
+    generation->addIncoming(builder.getInt32(0), stepEntry);
+    generation->addIncoming(nextGeneration, bb122);
 
-    val39->addIncoming(val28, bb23);
-    val39->addIncoming(builder.getInt32(0), bb29);
+    val16->addIncoming(builder.getInt64(1), generationStart);
+    val16->addIncoming(val18, bb57);
 
-    val57->addIncoming(val53, bb47);
-    val57->addIncoming(val44, bb54);
+    val20->addIncoming(builder.getInt64(1), bb15);
+    val20->addIncoming(val22, cellEnd);
 
-    val65->addIncoming(builder.getInt32(0), bb30);
-    val65->addIncoming(val44, bb55);
-
-    val72->addIncoming(val37, bb32);
-    val72->addIncoming(val63, bb56);
+    // The grid is exactly the size of the framebuffer, so the viewport always stays at 0, 0
+    FunctionType* appRenderFunctionType = FunctionType::get(
+        builder.getVoidTy(),
+        {builder.getInt32Ty(), builder.getInt32Ty()},
+        false
+    );
+    Function* appRenderFunction =
+        Function::Create(appRenderFunctionType, Function::ExternalLinkage, "appRender", module);
+
+    BasicBlock* renderEntry = BasicBlock::Create(context, "", appRenderFunction);
+    BasicBlock* bb118 = BasicBlock::Create(context, "", appRenderFunction);
+    BasicBlock* bb123 = BasicBlock::Create(context, "", appRenderFunction);
+    BasicBlock* bb126 = BasicBlock::Create(context, "", appRenderFunction);
+    BasicBlock* dirtyEntry = BasicBlock::Create(context, "", appRenderFunction);
+    BasicBlock* dirtyLoop = BasicBlock::Create(context, "", appRenderFunction);
+    BasicBlock* renderExit = BasicBlock::Create(context, "", appRenderFunction);
+
+    builder.SetInsertPoint(renderEntry);
+    Value* dirtyTotal = builder.CreateLoad(builder.getInt32Ty(), dirtyCount);
+    builder.CreateCondBr(
+        builder.CreateICmpUGT(dirtyTotal, builder.getInt32(2048)),
+        bb118,
+        dirtyEntry
+    );
 
-    val73->addIncoming(val33, bb32);
-    val73->addIncoming(val58, bb56);
+    // Only the listed cells are drawn, the framebuffer keeps the others from earlier frames
+    builder.SetInsertPoint(dirtyEntry);
+    builder.CreateCondBr(
+        builder.CreateICmpEQ(dirtyTotal, builder.getInt32(0)),
+        renderExit,
+        dirtyLoop
+    );
 
-    val85->addIncoming(val70, bb64);
-    val85->addIncoming(val83, bb71);
+    builder.SetInsertPoint(dirtyLoop);
+    PHINode* dirtyIndex = builder.CreatePHI(builder.getInt32Ty(), 2);
+    Value* listedCell = builder.CreateLoad(
+        builder.getInt32Ty(),
+        builder.CreateGEP(
+            dirtyCellsType,
+            dirtyCells,
+            {builder.getInt64(0), builder.CreateZExt(dirtyIndex, builder.getInt64Ty(), "", true)},
+            "",
+            true
+        )
+    );
+    Value* listedX = builder.CreateURem(listedCell, builder.getInt32(64));
+    Value* listedY = builder.CreateUDiv(listedCell, builder.getInt32(64));
+    Value* listedAlive = builder.CreateLoad(
+        builder.getInt32Ty(),
+        cellPointer(
+            val1,
+            builder.CreateZExt(
+                builder.CreateAdd(listedY, builder.getInt32(1), "", true, true),
+                builder.getInt64Ty(),
+                "",
+                true
+            ),
+            builder.CreateZExt(
+                builder.CreateAdd(listedX, builder.getInt32(1), "", true, true),
+                builder.getInt64Ty(),
+                "",
+                true
+            )
+        )
+    );
+    Value* listedColor = builder.CreateSelect(
+        builder.CreateICmpEQ(listedAlive, builder.getInt32(0)),
+        builder.getInt32(-16777216),
+        builder.getInt32(-1)
+    );
+    builder.CreateCall(simPutPixelFunction, {listedX, listedY, listedColor});
+    Value* nextDirtyIndex = builder.CreateAdd(dirtyIndex, builder.getInt32(1), "", true, true);
+    builder.CreateCondBr(builder.CreateICmpEQ(nextDirtyIndex, dirtyTotal), renderExit, dirtyLoop);
 
-    val94->addIncoming(val63, bb92);
-    val94->addIncoming(val44, bb55);
+    dirtyIndex->addIncoming(builder.getInt32(0), dirtyEntry);
+    dirtyIndex->addIncoming(nextDirtyIndex, dirtyLoop);
 
-    val97->addIncoming(val95, bb93);
-    val97->addIncoming(val86, bb84);
+    builder.SetInsertPoint(bb118);
+    PHINode* val119 = builder.CreatePHI(builder.getInt32Ty(), 2);
+    Value* val120 = builder.CreateAdd(val119, builder.getInt32(1), "", true, true);
+    Value* val121 = builder.CreateZExt(val120, builder.getInt64Ty(), "", true);
+    builder.CreateBr(bb126);
 
-    val98->addIncoming(val94, bb93);
-    val98->addIncoming(val91, bb84);
+    builder.SetInsertPoint(bb123);
+    Value* val125 = builder.CreateICmpEQ(val120, builder.getInt32(32));
+    builder.CreateCondBr(val125, renderExit, bb118);
 
-    val103->addIncoming(val63, bb92);
-    val103->addIncoming(val98, bb96);
-    val103->addIncoming(val83, bb71);
+    builder.SetInsertPoint(bb126);
+    PHINode* val127 = builder.CreatePHI(builder.getInt32Ty(), 2);
+    Value* val128 = builder.CreateAdd(val127, builder.getInt32(1), "", true, true);
+    Value* val129 = builder.CreateZExt(val128, builder.getInt64Ty(), "", true);
+    Value* val130 = cellPointer(val1, val121, val129);
+    Value* val131 = builder.CreateLoad(builder.getInt32Ty(), val130);
+    Value* val132 = builder.CreateICmpEQ(val131, builder.getInt32(0));
+    Value* val133 = builder.CreateSelect(val132, builder.getInt32(-16777216), builder.getInt32(-1));
+    builder.CreateCall(simPutPixelFunction, {val127, val119, val133});
+    Value* val135 = builder.CreateICmpEQ(val128, builder.getInt32(64));
+    builder.CreateCondBr(val135, bb123, bb126);
 
-    val104->addIncoming(builder.getInt1(false), bb92);
-    val104->addIncoming(val101, bb96);
-    val104->addIncoming(builder.getInt1(false), bb71);
+    builder.SetInsertPoint(renderExit);
+    builder.CreateStore(builder.getInt32(0), dirtyCount);
+    builder.CreateRetVoid();
 
-    val119->addIncoming(val124, bb123);
-    val119->addIncoming(builder.getInt32(0), bb15);
+    val119->addIncoming(builder.getInt32(0), renderEntry);
+    val119->addIncoming(val120, bb123);
 
     val127->addIncoming(builder.getInt32(0), bb118);
-    val127->addIncoming(val134, bb126);
+    val127->addIncoming(val128, bb126);
 
-    return {module, appFunction};
+    return {module};
 }
 
 void dumpModuleTo(std::string const& filename, Module* module)
@@ -434,10 +428,6 @@ struct FunctionCreator
         {
             return reinterpret_cast<void*>(simPutPixel);
         }
-        if (functionName == "simFlush")
-        {
-            return reinterpret_cast<void*>(simFlush);
-        }
         return nullptr;
     }
 };
@@ -451,8 +441,13 @@ void interpretApp(GeneratedIR const& generatedIR)
     engine->InstallLazyFunctionCreator(FunctionCreator());
     engine->finalizeObject();
 
-    simInit();
-    engine->runFunction(generatedIR.appFunction, {});
+    auto init = reinterpret_cast<void (*)()>(engine->getFunctionAddress("appInit"));
+    auto step = reinterpret_cast<void (*)(int)>(engine->getFunctionAddress("appStep"));
+    auto render = reinterpret_cast<void (*)(int, int)>(engine->getFunctionAddress("appRender"));
+
+    simInitLogical(SIM_X_SIZE / SIM_ZOOM, SIM_Y_SIZE / SIM_ZOOM);
+    init();
+    simRun(step, render);
     simExit();
 }
 } // namespace
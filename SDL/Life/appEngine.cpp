@@ -0,0 +1,80 @@
+#include "lifeEngine.h"
+
+#include "../lifeStep.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+// Runs the step of app.c itself: one byte per cell with a ring of dead ghost cells around the
+// grid, so the neighbours are summed without bounds checks, and the next state is looked up in
+// a table indexed by the cell and its neighbour count
+class AppEngine : public LifeEngine
+{
+  public:
+    AppEngine(int width, int height, LifeRule rule)
+        : width(width)
+        , height(height)
+        , stride(static_cast<std::size_t>(width) + 2)
+        , currentlyAlive(stride * (height + 2))
+        , nextAlive(stride * (height + 2))
+    {
+        for (int n = 0; n <= 8; ++n)
+        {
+            nextState[n] = rule.next(false, n);
+            nextState[9 + n] = rule.next(true, n);
+        }
+    }
+
+    void load(LifeGrid const& grid) override
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            std::uint8_t const* row = &grid.cells[static_cast<std::size_t>(y) * width];
+            std::transform(
+                row,
+                row + width,
+                currentlyAlive.begin() + (y + 1) * stride + 1,
+                [](std::uint8_t cell) { return cell != 0; }
+            );
+        }
+    }
+
+    void store(LifeGrid& grid) const override
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            auto row = currentlyAlive.begin() + (y + 1) * stride + 1;
+            std::copy(row, row + width, &grid.cells[static_cast<std::size_t>(y) * width]);
+        }
+    }
+
+    void step(std::uint64_t generations) override
+    {
+        for (std::uint64_t i = 0; i < generations; ++i)
+        {
+            lifeStep(currentlyAlive.data(), nextAlive.data(), stride, width, height, nextState);
+            std::swap(currentlyAlive, nextAlive);
+        }
+    }
+
+  private:
+    int width;
+    int height;
+    std::size_t stride;
+    std::uint8_t nextState[2 * 9];
+    std::vector<std::uint8_t> currentlyAlive;
+    std::vector<std::uint8_t> nextAlive;
+};
+} // namespace
+
+std::unique_ptr<LifeEngine> createAppEngine(int width, int height)
+{
+    return createAppEngine(width, height, conwayRule);
+}
+
+std::unique_ptr<LifeEngine> createAppEngine(int width, int height, LifeRule rule)
+{
+    return std::make_unique<AppEngine>(width, height, rule);
+}
@@ -0,0 +1,149 @@
+#include "bitSlice.h"
+#include "lifeEngine.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+using Word = std::uint64_t;
+
+constexpr int WORD_BITS = 64;
+
+// Cell x of a row lives in bit x % 64 of word x / 64. Every row is framed by a zero word on
+// each side and the grid by a zero row above and below, so the dead border of app.c needs
+// no bounds checks and padding bits past the width stay zero.
+class BitPackedEngine : public LifeEngine
+{
+  public:
+    BitPackedEngine(int width, int height, LifeRule rule)
+        : width(width)
+        , height(height)
+        , rule(rule)
+        , wordsPerRow((width + WORD_BITS - 1) / WORD_BITS)
+        , stride(wordsPerRow + 2)
+        , lastWordMask(width % WORD_BITS ? (Word(1) << width % WORD_BITS) - 1 : ~Word(0))
+        , current(static_cast<std::size_t>(stride) * (height + 2))
+        , next(static_cast<std::size_t>(stride) * (height + 2))
+    {
+    }
+
+    void load(LifeGrid const& grid) override
+    {
+        std::fill(current.begin(), current.end(), 0);
+        for (int y = 0; y < height; ++y)
+        {
+            Word* row = rowWords(current, y);
+            for (int x = 0; x < width; ++x)
+            {
+                row[x / WORD_BITS] |= Word(grid.at(x, y) != 0) << x % WORD_BITS;
+            }
+        }
+    }
+
+    void store(LifeGrid& grid) const override
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            Word const* row = rowWords(current, y);
+            for (int x = 0; x < width; ++x)
+            {
+                grid.at(x, y) = row[x / WORD_BITS] >> x % WORD_BITS & 1;
+            }
+        }
+    }
+
+    void step(std::uint64_t generations) override
+    {
+        visitLifeRule(
+            rule,
+            [&](auto kernelRule)
+            {
+                for (std::uint64_t i = 0; i < generations; ++i)
+                {
+                    for (int y = 0; y < height; ++y)
+                    {
+                        stepRow(
+                            rowWords(current, y - 1),
+                            rowWords(current, y),
+                            rowWords(current, y + 1),
+                            rowWords(next, y),
+                            kernelRule
+                        );
+                    }
+                    std::swap(current, next);
+                }
+            }
+        );
+    }
+
+  private:
+    int width;
+    int height;
+    LifeRule rule;
+    int wordsPerRow;
+    int stride;
+    Word lastWordMask;
+    std::vector<Word> current;
+    std::vector<Word> next;
+
+    Word* rowWords(std::vector<Word>& words, int y)
+    {
+        return words.data() + static_cast<std::size_t>(y + 1) * stride + 1;
+    }
+
+    Word const* rowWords(std::vector<Word> const& words, int y) const
+    {
+        return words.data() + static_cast<std::size_t>(y + 1) * stride + 1;
+    }
+
+    // Moves the west neighbour of every cell into the cell's bit
+    static Word west(Word const* row, int i)
+    {
+        return row[i] << 1 | row[i - 1] >> (WORD_BITS - 1);
+    }
+
+    // Moves the east neighbour of every cell into the cell's bit
+    static Word east(Word const* row, int i)
+    {
+        return row[i] >> 1 | row[i + 1] << (WORD_BITS - 1);
+    }
+
+    template <class Rule>
+    void stepRow(
+        Word const* above,
+        Word const* row,
+        Word const* below,
+        Word* result,
+        Rule kernelRule
+    ) const
+    {
+        for (int i = 0; i < wordsPerRow; ++i)
+        {
+            Word alive = bitSliceNextGeneration(
+                west(above, i),
+                above[i],
+                east(above, i),
+                west(row, i),
+                row[i],
+                east(row, i),
+                west(below, i),
+                below[i],
+                east(below, i),
+                kernelRule
+            );
+            result[i] = i == wordsPerRow - 1 ? alive & lastWordMask : alive;
+        }
+    }
+};
+} // namespace
+
+std::unique_ptr<LifeEngine> createBitPackedEngine(int width, int height)
+{
+    return createBitPackedEngine(width, height, conwayRule);
+}
+
+std::unique_ptr<LifeEngine> createBitPackedEngine(int width, int height, LifeRule rule)
+{
+    return std::make_unique<BitPackedEngine>(width, height, rule);
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "lifeRule.h"
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Bit-sliced Life: bit i of each word is a different cell, so every bitwise operation
+// works on 64 cells at once
+
+inline void bitSliceFullAdd(
+    std::uint64_t a,
+    std::uint64_t b,
+    std::uint64_t c,
+    std::uint64_t& sum,
+    std::uint64_t& carry
+)
+{
+    std::uint64_t partial = a ^ b;
+    sum = partial ^ c;
+    carry = (a & b) | (partial & c);
+}
+
+inline void bitSliceHalfAdd(
+    std::uint64_t a,
+    std::uint64_t b,
+    std::uint64_t& sum,
+    std::uint64_t& carry
+)
+{
+    sum = a ^ b;
+    carry = a & b;
+}
+
+// Cells with exactly n live neighbours, given the count in four bit planes
+inline std::uint64_t bitSliceCountIs(
+    int n,
+    std::uint64_t ones,
+    std::uint64_t twos,
+    std::uint64_t fours,
+    std::uint64_t eights
+)
+{
+    return (n & 1 ? ones : ~ones) & (n & 2 ? twos : ~twos) & (n & 4 ? fours : ~fours) &
+           (n & 8 ? eights : ~eights);
+}
+
+// Cells with n live neighbours that are alive in the next generation under the rule.
+// A count in both masks needs no look at the cell itself
+inline std::uint64_t bitSliceApplyCount(
+    int n,
+    bool born,
+    bool survives,
+    std::uint64_t self,
+    std::uint64_t ones,
+    std::uint64_t twos,
+    std::uint64_t fours,
+    std::uint64_t eights
+)
+{
+    if (!born && !survives)
+    {
+        return 0;
+    }
+    std::uint64_t count = bitSliceCountIs(n, ones, twos, fours, eights);
+    return born && survives ? count : count & (born ? ~self : self);
+}
+
+// Applies a LifeRule or a LifeRuleConstant to 64 cells. For constants the counts are unrolled
+// at compile time, so only the counts the rule uses are compared
+template <class Rule>
+inline std::uint64_t bitSliceApplyRule(
+    Rule rule,
+    std::uint64_t self,
+    std::uint64_t ones,
+    std::uint64_t twos,
+    std::uint64_t fours,
+    std::uint64_t eights
+)
+{
+    if constexpr (std::is_same_v<Rule, LifeRule>)
+    {
+        std::uint64_t result = 0;
+        for (int n = 0; n <= 8; ++n)
+        {
+            result |= bitSliceApplyCount(
+                n, rule.birth >> n & 1, rule.survival >> n & 1, self, ones, twos, fours, eights
+            );
+        }
+        return result;
+    }
+    else
+    {
+        constexpr LifeRule masks = Rule::value;
+        return [&]<int... n>(std::integer_sequence<int, n...>)
+        {
+            return (
+                bitSliceApplyCount(
+                    n, masks.birth >> n & 1, masks.survival >> n & 1, self, ones, twos, fours, eights
+                ) |
+                ...
+            );
+        }(std::make_integer_sequence<int, 9>{});
+    }
+}
+
+// Adds the eight neighbour planes of 64 cells, keeping the count in four bit planes.
+// Each row is given as the cells themselves and with the west and east neighbour
+// of every cell shifted into the cell's bit. The rule is a LifeRule or a LifeRuleConstant,
+// for which bitSliceApplyRule folds down to the counts the rule uses.
+template <class Rule = LifeRuleConstant<conwayRule>>
+inline std::uint64_t bitSliceNextGeneration(
+    std::uint64_t aboveWest,
+    std::uint64_t above,
+    std::uint64_t aboveEast,
+    std::uint64_t west,
+    std::uint64_t self,
+    std::uint64_t east,
+    std::uint64_t belowWest,
+    std::uint64_t below,
+    std::uint64_t belowEast,
+    Rule rule = {}
+)
+{
+    std::uint64_t aboveOnes, aboveTwos;
+    bitSliceFullAdd(aboveWest, above, aboveEast, aboveOnes, aboveTwos);
+    std::uint64_t belowOnes, belowTwos;
+    bitSliceFullAdd(belowWest, below, belowEast, belowOnes, belowTwos);
+    std::uint64_t sideOnes, sideTwos;
+    bitSliceHalfAdd(west, east, sideOnes, sideTwos);
+
+    std::uint64_t ones, onesCarry;
+    bitSliceFullAdd(aboveOnes, belowOnes, sideOnes, ones, onesCarry);
+    std::uint64_t partialTwos, twosCarry;
+    bitSliceFullAdd(aboveTwos, belowTwos, sideTwos, partialTwos, twosCarry);
+    std::uint64_t twos, partialFours;
+    bitSliceHalfAdd(partialTwos, onesCarry, twos, partialFours);
+    std::uint64_t fours, eights;
+    bitSliceHalfAdd(twosCarry, partialFours, fours, eights);
+
+    if constexpr (std::is_same_v<Rule, LifeRuleConstant<conwayRule>>)
+    {
+        // Alive with 3 neighbours, or alive already with 2
+        return twos & ~fours & ~eights & (ones | self);
+    }
+    else
+    {
+        return bitSliceApplyRule(rule, self, ones, twos, fours, eights);
+    }
+}
@@ -0,0 +1,238 @@
+#include "lifeEngine.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace
+{
+// A 4x4 neighbourhood made of four 2x2 blocks packed as top-left | top-right << 4 |
+// bottom-left << 8 | bottom-right << 12, where a block holds cell (x, y) in bit y * 2 + x
+using BlockTable = std::array<std::uint8_t, 1 << 16>;
+
+// Width of the column strips the grid is stepped in. Two input rows and one output row of a
+// strip take 12 KiB, so together with the 64 KiB table they stay in L2 however wide the grid
+// is, while narrower strips would only cost the hardware prefetcher its long row streams
+constexpr int TILE_BLOCKS = 4096;
+
+constexpr int neighbourhoodBit(int x, int y)
+{
+    return (y / 2 * 2 + x / 2) * 4 + y % 2 * 2 + x % 2;
+}
+
+constexpr unsigned neighbourMask(int x, int y)
+{
+    unsigned mask = 0;
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            mask |= (dx || dy) ? 1u << neighbourhoodBit(x + dx, y + dy) : 0;
+        }
+    }
+    return mask;
+}
+
+// Neighbours of the four centre cells (1, 1), (2, 1), (1, 2) and (2, 2)
+constexpr unsigned neighbourMasks[4] = {
+    neighbourMask(1, 1),
+    neighbourMask(2, 1),
+    neighbourMask(1, 2),
+    neighbourMask(2, 2),
+};
+constexpr int centreBits[4] = {
+    neighbourhoodBit(1, 1),
+    neighbourhoodBit(2, 1),
+    neighbourhoodBit(1, 2),
+    neighbourhoodBit(2, 2),
+};
+
+// Kept to a single expression, so the 64K evaluations fit the constexpr step limits
+constexpr std::uint8_t nextCentreCell(LifeRule rule, unsigned neighbourhood, int cell)
+{
+    return ((neighbourhood >> centreBits[cell] & 1 ? rule.survival : rule.birth) >>
+                __builtin_popcount(neighbourhood & neighbourMasks[cell]) &
+            1)
+           << cell;
+}
+
+constexpr BlockTable makeBlockTable(LifeRule rule)
+{
+    BlockTable table{};
+    for (unsigned neighbourhood = 0; neighbourhood < table.size(); ++neighbourhood)
+    {
+        table[neighbourhood] = nextCentreCell(rule, neighbourhood, 0) |
+                               nextCentreCell(rule, neighbourhood, 1) |
+                               nextCentreCell(rule, neighbourhood, 2) |
+                               nextCentreCell(rule, neighbourhood, 3);
+    }
+    return table;
+}
+
+// Built by the compiler for the default rule, other rules build the same table at startup
+constexpr BlockTable conwayBlockTable = makeBlockTable(conwayRule);
+
+static_assert(conwayBlockTable[0x0000] == 0x0, "Empty space stays empty");
+static_assert(conwayBlockTable[0x1248] == 0xF, "A block in the centre is a still life");
+
+// The grid is stored as 2x2 blocks of one byte each, and a step replaces the 4x4 neighbourhood
+// of four blocks by its centre block with one table lookup. The centres of the next
+// generation sit one cell down and to the right of the blocks, so generations alternate
+// between two block layouts shifted by a cell and every step reads the four blocks on the
+// other side. Cells are offset by two so that a ring of dead blocks surrounds the grid,
+// and cells of the edge blocks outside the grid are masked away after every lookup.
+class BlockTableEngine : public LifeEngine
+{
+  public:
+    BlockTableEngine(int width, int height, LifeRule rule)
+        : width(width)
+        , height(height)
+        , table(tableFor(rule, ownTable))
+        , blocksPerRow(width / 2 + 3)
+        , blockRows(height / 2 + 3)
+    {
+        for (int phase = 0; phase < 2; ++phase)
+        {
+            blocks[phase].resize(static_cast<std::size_t>(blocksPerRow) * blockRows);
+            columnMasks[phase].resize(blocksPerRow);
+            rowMasks[phase].resize(blockRows);
+            for (int bx = 0; bx < blocksPerRow; ++bx)
+            {
+                int mask = cellMask(bx, phase, width);
+                columnMasks[phase][bx] = (mask & 1) * 0x5 | (mask >> 1) * 0xA;
+            }
+            for (int by = 0; by < blockRows; ++by)
+            {
+                int mask = cellMask(by, phase, height);
+                rowMasks[phase][by] = (mask & 1) * 0x3 | (mask >> 1) * 0xC;
+            }
+        }
+    }
+
+    void load(LifeGrid const& grid) override
+    {
+        phase = 0;
+        std::fill(blocks[0].begin(), blocks[0].end(), 0);
+        std::fill(blocks[1].begin(), blocks[1].end(), 0);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto [block, bit] = locate(x, y);
+                blocks[0][block] |= (grid.at(x, y) != 0) << bit;
+            }
+        }
+    }
+
+    void store(LifeGrid& grid) const override
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto [block, bit] = locate(x, y);
+                grid.at(x, y) = blocks[phase][block] >> bit & 1;
+            }
+        }
+    }
+
+    void step(std::uint64_t generations) override
+    {
+        for (std::uint64_t i = 0; i < generations; ++i)
+        {
+            if (phase == 0)
+            {
+                stepTiles(blocks[0], blocks[1], 0, 0, blocksPerRow - 2, blockRows - 2);
+            }
+            else
+            {
+                stepTiles(blocks[1], blocks[0], -1, 1, blocksPerRow - 1, blockRows - 1);
+            }
+            phase ^= 1;
+        }
+    }
+
+  private:
+    int width;
+    int height;
+    std::unique_ptr<BlockTable> ownTable;
+    std::uint8_t const* table;
+    int blocksPerRow;
+    int blockRows;
+    // Layout 0 holds even generations and starts its blocks on even padded cells
+    int phase = 0;
+    std::vector<std::uint8_t> blocks[2];
+    std::vector<std::uint8_t> columnMasks[2];
+    std::vector<std::uint8_t> rowMasks[2];
+
+    static std::uint8_t const* tableFor(LifeRule rule, std::unique_ptr<BlockTable>& storage)
+    {
+        if (rule == conwayRule)
+        {
+            return conwayBlockTable.data();
+        }
+        storage = std::make_unique<BlockTable>(makeBlockTable(rule));
+        return storage->data();
+    }
+
+    // Bit 0 is set if the first cell of block b of a layout lies inside the grid, bit 1 if the
+    // second one does
+    static int cellMask(int b, int phase, int size)
+    {
+        int first = 2 * b + phase - 2;
+        return (first >= 0 && first < size) | (first + 1 >= 0 && first + 1 < size) << 1;
+    }
+
+    std::pair<std::size_t, int> locate(int x, int y) const
+    {
+        int paddedX = x + 2 - phase;
+        int paddedY = y + 2 - phase;
+        std::size_t block = static_cast<std::size_t>(paddedY / 2) * blocksPerRow + paddedX / 2;
+        return {block, paddedY % 2 * 2 + paddedX % 2};
+    }
+
+    // Writes blocks [first, last] of both axes of the other layout. The neighbourhood of
+    // block (bx, by) starts at block (bx + shift, by + shift) of the current one
+    void stepTiles(
+        std::vector<std::uint8_t> const& from,
+        std::vector<std::uint8_t>& to,
+        int shift,
+        int first,
+        int lastX,
+        int lastY
+    ) const
+    {
+        std::uint8_t const* columnMask = columnMasks[phase ^ 1].data();
+        for (int tileX = first; tileX <= lastX; tileX += TILE_BLOCKS)
+        {
+            int tileEnd = std::min(tileX + TILE_BLOCKS - 1, lastX);
+            for (int by = first; by <= lastY; ++by)
+            {
+                std::uint8_t const* top =
+                    from.data() + static_cast<std::size_t>(by + shift) * blocksPerRow + shift;
+                std::uint8_t const* bottom = top + blocksPerRow;
+                std::uint8_t* result = to.data() + static_cast<std::size_t>(by) * blocksPerRow;
+                std::uint8_t rowMask = rowMasks[phase ^ 1][by];
+                // The right half of a neighbourhood is the left half of the next one
+                unsigned left = top[tileX] | bottom[tileX] << 8;
+                for (int bx = tileX; bx <= tileEnd; ++bx)
+                {
+                    unsigned right = top[bx + 1] | bottom[bx + 1] << 8;
+                    result[bx] = table[left | right << 4] & columnMask[bx] & rowMask;
+                    left = right;
+                }
+            }
+        }
+    }
+};
+} // namespace
+
+std::unique_ptr<LifeEngine> createBlockTableEngine(int width, int height)
+{
+    return createBlockTableEngine(width, height, conwayRule);
+}
+
+std::unique_ptr<LifeEngine> createBlockTableEngine(int width, int height, LifeRule rule)
+{
+    return std::make_unique<BlockTableEngine>(width, height, rule);
+}
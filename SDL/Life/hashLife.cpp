@@ -0,0 +1,528 @@
+#include "hashLife.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+constexpr int MIN_ROOT_LEVEL = 3;
+constexpr std::size_t INITIAL_TABLE_SIZE = 1 << 16;
+
+std::uint64_t hashChildren(std::uint64_t nw, std::uint64_t ne, std::uint64_t sw, std::uint64_t se)
+{
+    std::uint64_t hash = (nw * 0x9E3779B97F4A7C15ULL + ne) * 0xC2B2AE3D27D4EB4FULL;
+    hash = (hash + sw) * 0x165667B19E3779F9ULL + se;
+    return hash ^ hash >> 29;
+}
+} // namespace
+
+HashLife::HashLife(std::size_t memoryBudget)
+    : memoryBudget(memoryBudget)
+{
+    clear();
+}
+
+void HashLife::clear()
+{
+    nodes.clear();
+    emptyNodes.clear();
+    nodes.push_back({NONE, NONE, NONE, NONE, NONE, -1, 0, 0});
+    nodes.push_back({NONE, NONE, NONE, NONE, NONE, -1, 0, 1});
+    rehash(INITIAL_TABLE_SIZE);
+    root = empty(MIN_ROOT_LEVEL);
+    generationCount = 0;
+    collectionThreshold = memoryBudget;
+}
+
+HashLife::NodeId HashLife::makeNode(NodeId nw, NodeId ne, NodeId sw, NodeId se)
+{
+    std::size_t mask = table.size() - 1;
+    std::size_t bucket = hashChildren(nw, ne, sw, se) & mask;
+    for (; table[bucket] != NONE; bucket = (bucket + 1) & mask)
+    {
+        Node const& node = nodes[table[bucket]];
+        if (node.nw == nw && node.ne == ne && node.sw == sw && node.se == se)
+        {
+            return table[bucket];
+        }
+    }
+
+    NodeId id = static_cast<NodeId>(nodes.size());
+    nodes.push_back(
+        {nw,
+         ne,
+         sw,
+         se,
+         NONE,
+         -1,
+         static_cast<std::uint8_t>(nodes[nw].level + 1),
+         nodes[nw].population + nodes[ne].population + nodes[sw].population +
+             nodes[se].population}
+    );
+    if (nodes.size() * 2 > table.size())
+    {
+        rehash(table.size() * 2);
+    }
+    else
+    {
+        insert(id);
+    }
+    return id;
+}
+
+void HashLife::insert(NodeId id)
+{
+    Node const& node = nodes[id];
+    std::size_t mask = table.size() - 1;
+    std::size_t bucket = hashChildren(node.nw, node.ne, node.sw, node.se) & mask;
+    while (table[bucket] != NONE)
+    {
+        bucket = (bucket + 1) & mask;
+    }
+    table[bucket] = id;
+}
+
+void HashLife::rehash(std::size_t buckets)
+{
+    table.assign(buckets, NONE);
+    for (NodeId id = 0; id < nodes.size(); ++id)
+    {
+        if (nodes[id].level > 0)
+        {
+            insert(id);
+        }
+    }
+}
+
+HashLife::NodeId HashLife::empty(int level)
+{
+    if (emptyNodes.empty())
+    {
+        emptyNodes.push_back(DEAD);
+    }
+    while (static_cast<int>(emptyNodes.size()) <= level)
+    {
+        NodeId child = emptyNodes.back();
+        emptyNodes.push_back(makeNode(child, child, child, child));
+    }
+    return emptyNodes[level];
+}
+
+HashLife::NodeId HashLife::centre(NodeId id)
+{
+    Node node = nodes[id];
+    return makeNode(nodes[node.nw].se, nodes[node.ne].sw, nodes[node.sw].ne, nodes[node.se].nw);
+}
+
+HashLife::NodeId HashLife::expand(NodeId id)
+{
+    Node node = nodes[id];
+    NodeId border = empty(node.level - 1);
+    return makeNode(
+        makeNode(border, border, border, node.nw),
+        makeNode(border, border, node.ne, border),
+        makeNode(border, node.sw, border, border),
+        makeNode(node.se, border, border, border)
+    );
+}
+
+HashLife::NodeId HashLife::successorOfLevel2(NodeId id)
+{
+    Node node = nodes[id];
+    int cells = 0;
+    NodeId const quadrants[] = {node.nw, node.ne, node.sw, node.se};
+    for (int quadrant = 0; quadrant < 4; ++quadrant)
+    {
+        Node const& child = nodes[quadrants[quadrant]];
+        int x = quadrant % 2 * 2;
+        int y = quadrant / 2 * 2;
+        cells |= (child.nw == ALIVE) << (y * 4 + x);
+        cells |= (child.ne == ALIVE) << (y * 4 + x + 1);
+        cells |= (child.sw == ALIVE) << ((y + 1) * 4 + x);
+        cells |= (child.se == ALIVE) << ((y + 1) * 4 + x + 1);
+    }
+
+    auto next = [cells](int x, int y)
+    {
+        int neighbours = 0;
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                neighbours += (dx != 0 || dy != 0) && (cells >> ((y + dy) * 4 + x + dx) & 1);
+            }
+        }
+        bool alive = cells >> (y * 4 + x) & 1;
+        return neighbours == 3 || (alive && neighbours == 2) ? ALIVE : DEAD;
+    };
+    return makeNode(next(1, 1), next(2, 1), next(1, 2), next(2, 2));
+}
+
+// The centre half of a level k node advanced 2^step generations, step <= k - 2
+HashLife::NodeId HashLife::successor(NodeId id, int step)
+{
+    Node node = nodes[id];
+    if (node.population == 0)
+    {
+        return empty(node.level - 1);
+    }
+    if (node.result != NONE && node.resultStep == step)
+    {
+        return node.result;
+    }
+
+    NodeId result;
+    if (node.level == 2)
+    {
+        result = successorOfLevel2(id);
+    }
+    else
+    {
+        Node nw = nodes[node.nw];
+        Node ne = nodes[node.ne];
+        Node sw = nodes[node.sw];
+        Node se = nodes[node.se];
+
+        // Nine overlapping subnodes of half the size
+        NodeId parts[3][3] = {
+            {node.nw, makeNode(nw.ne, ne.nw, nw.se, ne.sw), node.ne},
+            {makeNode(nw.sw, nw.se, sw.nw, sw.ne),
+             makeNode(nw.se, ne.sw, sw.ne, se.nw),
+             makeNode(ne.sw, ne.se, se.nw, se.ne)},
+            {node.sw, makeNode(sw.ne, se.nw, sw.se, se.sw), node.se},
+        };
+
+        // A full step spends half of the time on each stage,
+        // a shorter one only moves the subnodes into place in the first stage
+        bool fullStep = step == node.level - 2;
+        int stageStep = fullStep ? step - 1 : step;
+        for (auto& row : parts)
+        {
+            for (NodeId& part : row)
+            {
+                part = fullStep ? successor(part, stageStep) : centre(part);
+            }
+        }
+
+        NodeId quadrants[2][2];
+        for (int y = 0; y < 2; ++y)
+        {
+            for (int x = 0; x < 2; ++x)
+            {
+                quadrants[y][x] = successor(
+                    makeNode(parts[y][x], parts[y][x + 1], parts[y + 1][x], parts[y + 1][x + 1]),
+                    stageStep
+                );
+            }
+        }
+        result = makeNode(quadrants[0][0], quadrants[0][1], quadrants[1][0], quadrants[1][1]);
+    }
+
+    nodes[id].result = result;
+    nodes[id].resultStep = static_cast<std::int8_t>(step);
+    return result;
+}
+
+void HashLife::stepPowerOfTwo(int k)
+{
+    // Expand until the pattern is within the centre quarter of a root large enough for the step,
+    // so nothing can leave the centre half that becomes the new root
+    while (nodes[root].level < k + 2 || nodes[centre(root)].population != nodes[root].population)
+    {
+        root = expand(root);
+    }
+    root = successor(expand(root), k);
+    generationCount += std::uint64_t(1) << k;
+
+    if (memoryUsed() > collectionThreshold)
+    {
+        collectGarbage();
+    }
+}
+
+void HashLife::step(std::uint64_t generations)
+{
+    for (int k = 0; generations >> k != 0; ++k)
+    {
+        if (generations >> k & 1)
+        {
+            stepPowerOfTwo(k);
+        }
+    }
+}
+
+std::uint64_t HashLife::population() const
+{
+    return nodes[root].population;
+}
+
+std::size_t HashLife::memoryUsed() const
+{
+    return nodes.capacity() * sizeof(Node) + table.capacity() * sizeof(NodeId);
+}
+
+void HashLife::collectGarbage()
+{
+    // Live nodes are the tree under the root and the empty nodes; memoised results
+    // of live nodes survive only if they are live themselves
+    std::vector<NodeId> remap(nodes.size(), NONE);
+    std::vector<NodeId> pending(emptyNodes.begin(), emptyNodes.end());
+    pending.push_back(root);
+    pending.push_back(ALIVE);
+    while (!pending.empty())
+    {
+        NodeId id = pending.back();
+        pending.pop_back();
+        if (remap[id] != NONE)
+        {
+            continue;
+        }
+        remap[id] = 0;
+        Node const& node = nodes[id];
+        if (node.level > 0)
+        {
+            pending.insert(pending.end(), {node.nw, node.ne, node.sw, node.se});
+        }
+    }
+
+    // Children are always created before their parents, so compacting in order keeps
+    // every child id below its parent id
+    NodeId live = 0;
+    for (NodeId& id : remap)
+    {
+        if (id != NONE)
+        {
+            id = live++;
+        }
+    }
+
+    std::vector<Node> compacted;
+    compacted.reserve(live);
+    for (NodeId id = 0; id < nodes.size(); ++id)
+    {
+        if (remap[id] == NONE)
+        {
+            continue;
+        }
+        Node node = nodes[id];
+        if (node.level > 0)
+        {
+            node.nw = remap[node.nw];
+            node.ne = remap[node.ne];
+            node.sw = remap[node.sw];
+            node.se = remap[node.se];
+        }
+        if (node.result != NONE)
+        {
+            node.result = remap[node.result];
+        }
+        compacted.push_back(node);
+    }
+
+    nodes = std::move(compacted);
+    for (NodeId& id : emptyNodes)
+    {
+        id = remap[id];
+    }
+    root = remap[root];
+
+    std::size_t buckets = INITIAL_TABLE_SIZE;
+    while (buckets < nodes.size() * 2)
+    {
+        buckets *= 2;
+    }
+    rehash(buckets);
+
+    // A live tree over the budget would otherwise be collected again after every step
+    collectionThreshold = std::max(memoryBudget, 2 * memoryUsed());
+}
+
+HashLife::NodeId HashLife::build(
+    LifeGrid const& grid,
+    std::int64_t gridX,
+    std::int64_t gridY,
+    int level,
+    std::int64_t x,
+    std::int64_t y
+)
+{
+    std::int64_t size = std::int64_t(1) << level;
+    if (x + size <= gridX || x >= gridX + grid.width || y + size <= gridY ||
+        y >= gridY + grid.height)
+    {
+        return empty(level);
+    }
+    if (level == 0)
+    {
+        return grid.at(x - gridX, y - gridY) ? ALIVE : DEAD;
+    }
+
+    std::int64_t half = size / 2;
+    NodeId nw = build(grid, gridX, gridY, level - 1, x, y);
+    NodeId ne = build(grid, gridX, gridY, level - 1, x + half, y);
+    NodeId sw = build(grid, gridX, gridY, level - 1, x, y + half);
+    NodeId se = build(grid, gridX, gridY, level - 1, x + half, y + half);
+    return makeNode(nw, ne, sw, se);
+}
+
+void HashLife::load(LifeGrid const& grid, std::int64_t x, std::int64_t y)
+{
+    clear();
+    std::int64_t extent = std::max(
+        {std::abs(x), std::abs(y), std::abs(x + grid.width), std::abs(y + grid.height)}
+    );
+    int level = MIN_ROOT_LEVEL;
+    while ((std::int64_t(1) << (level - 1)) < extent)
+    {
+        ++level;
+    }
+    std::int64_t half = std::int64_t(1) << (level - 1);
+    root = build(grid, x, y, level, -half, -half);
+}
+
+void HashLife::collect(
+    NodeId id,
+    std::int64_t x,
+    std::int64_t y,
+    LifeGrid& viewport,
+    std::int64_t viewportX,
+    std::int64_t viewportY
+) const
+{
+    Node const& node = nodes[id];
+    std::int64_t size = std::int64_t(1) << node.level;
+    if (node.population == 0 || x + size <= viewportX || x >= viewportX + viewport.width ||
+        y + size <= viewportY || y >= viewportY + viewport.height)
+    {
+        return;
+    }
+    if (node.level == 0)
+    {
+        viewport.at(x - viewportX, y - viewportY) = 1;
+        return;
+    }
+
+    std::int64_t half = size / 2;
+    collect(node.nw, x, y, viewport, viewportX, viewportY);
+    collect(node.ne, x + half, y, viewport, viewportX, viewportY);
+    collect(node.sw, x, y + half, viewport, viewportX, viewportY);
+    collect(node.se, x + half, y + half, viewport, viewportX, viewportY);
+}
+
+void HashLife::extract(LifeGrid& viewport, std::int64_t x, std::int64_t y) const
+{
+    std::fill(viewport.cells.begin(), viewport.cells.end(), 0);
+    collect(root, -rootHalf(), -rootHalf(), viewport, x, y);
+}
+
+bool HashLife::cell(std::int64_t x, std::int64_t y) const
+{
+    std::int64_t half = rootHalf();
+    if (x < -half || x >= half || y < -half || y >= half)
+    {
+        return false;
+    }
+
+    x += half;
+    y += half;
+    NodeId id = root;
+    for (int level = nodes[root].level; level > 0; --level)
+    {
+        Node const& node = nodes[id];
+        std::int64_t childSize = std::int64_t(1) << (level - 1);
+        bool east = x >= childSize;
+        bool south = y >= childSize;
+        id = south ? (east ? node.se : node.sw) : (east ? node.ne : node.nw);
+        x -= east ? childSize : 0;
+        y -= south ? childSize : 0;
+    }
+    return id == ALIVE;
+}
+
+HashLife::NodeId HashLife::withCell(NodeId id, std::int64_t x, std::int64_t y, bool alive)
+{
+    Node node = nodes[id];
+    if (node.level == 0)
+    {
+        return alive ? ALIVE : DEAD;
+    }
+
+    std::int64_t childSize = std::int64_t(1) << (node.level - 1);
+    bool east = x >= childSize;
+    bool south = y >= childSize;
+    NodeId& child = south ? (east ? node.se : node.sw) : (east ? node.ne : node.nw);
+    child = withCell(child, x - (east ? childSize : 0), y - (south ? childSize : 0), alive);
+    return makeNode(node.nw, node.ne, node.sw, node.se);
+}
+
+void HashLife::setCell(std::int64_t x, std::int64_t y, bool alive)
+{
+    while (x < -rootHalf() || x >= rootHalf() || y < -rootHalf() || y >= rootHalf())
+    {
+        root = expand(root);
+    }
+    root = withCell(root, x + rootHalf(), y + rootHalf(), alive);
+}
+
+namespace
+{
+constexpr std::size_t DEFAULT_MEMORY_BUDGET_MB = 512;
+
+// Shows the window [0, width) x [0, height) of the unbounded universe, so unlike
+// the other engines patterns do not die at the edges of the grid but leave it
+class HashLifeEngine : public LifeEngine
+{
+  public:
+    explicit HashLifeEngine(std::size_t memoryBudget)
+        : life(memoryBudget)
+    {
+    }
+
+    void load(LifeGrid const& grid) override
+    {
+        life.load(grid, 0, 0);
+    }
+
+    void store(LifeGrid& grid) const override
+    {
+        life.extract(grid, 0, 0);
+    }
+
+    void step(std::uint64_t generations) override
+    {
+        life.step(generations);
+    }
+
+    std::vector<LifeMetric> metrics() const override
+    {
+        return {{"hashlife_nodes", life.nodeCount()}};
+    }
+
+  private:
+    HashLife life;
+};
+} // namespace
+
+std::unique_ptr<LifeEngine> createHashLifeEngine(int, int)
+{
+    char const* budget = std::getenv("LIFE_HASHLIFE_MB");
+    std::size_t megabytes = DEFAULT_MEMORY_BUDGET_MB;
+    if (budget)
+    {
+        char* end = nullptr;
+        unsigned long long parsed = std::strtoull(budget, &end, 10);
+        if (!std::isdigit(static_cast<unsigned char>(budget[0])) || *end != '\0' || parsed == 0
+            || parsed > SIZE_MAX >> 20)
+        {
+            std::fprintf(
+                stderr, "[hashlife] Bad LIFE_HASHLIFE_MB '%s', expected megabytes\n", budget
+            );
+            std::exit(EXIT_FAILURE);
+        }
+        megabytes = parsed;
+    }
+    return std::make_unique<HashLifeEngine>(megabytes << 20);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "lifeEngine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Gosper's HashLife over an unbounded universe.
+// The universe is a quadtree whose nodes are hash-consed, so equal subtrees are stored once,
+// and every node memoises its RESULT: the centre half of the node advanced in time.
+// Coordinates are signed, the root always spans [-2^(level-1), 2^(level-1)) on both axes.
+class HashLife
+{
+  public:
+    // Unreachable nodes are collected between steps once the node table outgrows the budget,
+    // or twice the memory left after the last collection if that is larger
+    explicit HashLife(std::size_t memoryBudget);
+
+    void clear();
+    // Replaces the universe with the grid placed with its top left corner at (x, y)
+    void load(LifeGrid const& grid, std::int64_t x, std::int64_t y);
+    // Copies the viewport with its top left corner at (x, y) out of the universe
+    void extract(LifeGrid& viewport, std::int64_t x, std::int64_t y) const;
+
+    bool cell(std::int64_t x, std::int64_t y) const;
+    void setCell(std::int64_t x, std::int64_t y, bool alive);
+
+    // Advances 2^k generations at once
+    void stepPowerOfTwo(int k);
+    void step(std::uint64_t generations);
+
+    std::uint64_t generation() const
+    {
+        return generationCount;
+    }
+
+    std::uint64_t population() const;
+    std::size_t nodeCount() const
+    {
+        return nodes.size();
+    }
+    std::size_t memoryUsed() const;
+
+    void collectGarbage();
+
+  private:
+    using NodeId = std::uint32_t;
+
+    // Level 0 nodes are single cells, a level k node is a square of 2^k x 2^k cells
+    struct Node
+    {
+        NodeId nw, ne, sw, se;
+        NodeId result;
+        std::int8_t resultStep;
+        std::uint8_t level;
+        std::uint64_t population;
+    };
+
+    static constexpr NodeId DEAD = 0;
+    static constexpr NodeId ALIVE = 1;
+    static constexpr NodeId NONE = ~NodeId(0);
+
+    std::size_t memoryBudget;
+    // Memory use that starts the next collection, at least twice what the last one kept
+    std::size_t collectionThreshold;
+    std::vector<Node> nodes;
+    // Open addressing table of node ids keyed by their children
+    std::vector<NodeId> table;
+    std::vector<NodeId> emptyNodes;
+    NodeId root;
+    std::uint64_t generationCount = 0;
+
+    NodeId makeNode(NodeId nw, NodeId ne, NodeId sw, NodeId se);
+    NodeId empty(int level);
+    void insert(NodeId id);
+    void rehash(std::size_t buckets);
+
+    NodeId centre(NodeId id);
+    NodeId expand(NodeId id);
+    NodeId successor(NodeId id, int step);
+    NodeId successorOfLevel2(NodeId id);
+
+    // Node positions are given by the universe coordinates of their top left corner
+    NodeId build(
+        LifeGrid const& grid,
+        std::int64_t gridX,
+        std::int64_t gridY,
+        int level,
+        std::int64_t x,
+        std::int64_t y
+    );
+    NodeId withCell(NodeId id, std::int64_t x, std::int64_t y, bool alive);
+    void collect(
+        NodeId id,
+        std::int64_t x,
+        std::int64_t y,
+        LifeGrid& viewport,
+        std::int64_t viewportX,
+        std::int64_t viewportY
+    ) const;
+
+    std::int64_t rootHalf() const
+    {
+        return std::int64_t(1) << (nodes[root].level - 1);
+    }
+};
@@ -0,0 +1,90 @@
+#include "../pattern.h"
+#include "../sim.h"
+#include "lifeEngine.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+// Same scene as app.c (including LIFE_PATTERN and LIFE_RULE), stepped by the engine named in
+// LIFE_ENGINE (scalar by default)
+
+#define ZOOMED_Y_SIZE (SIM_Y_SIZE / SIM_ZOOM + (SIM_Y_SIZE % SIM_ZOOM != 0))
+#define ZOOMED_X_SIZE (SIM_X_SIZE / SIM_ZOOM + (SIM_X_SIZE % SIM_ZOOM != 0))
+#define CENTER_Y (ZOOMED_Y_SIZE / 2)
+#define CENTER_X (ZOOMED_X_SIZE / 2)
+
+namespace
+{
+std::unique_ptr<LifeEngine> Engine;
+LifeGrid Grid(ZOOMED_X_SIZE, ZOOMED_Y_SIZE);
+} // namespace
+
+void appInit()
+{
+    LifeRule rule = toLifeRule(ruleFromEnvironment());
+    char const* engineName = std::getenv("LIFE_ENGINE");
+    Engine = createLifeEngine(
+        engineName ? engineName : "scalar", ZOOMED_X_SIZE, ZOOMED_Y_SIZE, rule
+    );
+    if (!Engine)
+    {
+        std::fprintf(
+            stderr,
+            "[life] Unknown LIFE_ENGINE '%s', or one that cannot run LIFE_RULE; choose from",
+            engineName
+        );
+        for (LifeEngineInfo const& engine : lifeEngines())
+        {
+            if (rule == conwayRule || engine.createWithRule)
+            {
+                std::fprintf(stderr, " %s", engine.name);
+            }
+        }
+        std::fprintf(stderr, "\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    LifeGrid& grid = Grid;
+    if (!patternLoadFromEnvironment(grid.cells.data(), grid.width, grid.width, grid.height))
+    {
+#ifdef SOUP_DENSITY
+        std::vector<int> soup(grid.cells.size());
+        simRandFill(soup.data(), soup.size());
+        for (std::size_t i = 0; i < soup.size(); ++i)
+        {
+            grid.cells[i] = soup[i] % 100 < SOUP_DENSITY;
+        }
+#else
+        grid.at(CENTER_X, CENTER_Y - 1) = 1;
+        grid.at(CENTER_X + 1, CENTER_Y - 1) = 1;
+        grid.at(CENTER_X - 1, CENTER_Y) = 1;
+        grid.at(CENTER_X, CENTER_Y) = 1;
+        grid.at(CENTER_X, CENTER_Y + 1) = 1;
+#endif
+    }
+    Engine->load(grid);
+}
+
+void appStep(int generations)
+{
+    Engine->step(generations);
+    for (LifeMetric const& metric : Engine->metrics())
+    {
+        simMetric(metric.name, metric.value);
+    }
+}
+
+// The engine grid is the size of the framebuffer, so the viewport never moves
+void appRender(int, int)
+{
+    Engine->store(Grid);
+    for (int y = 0; y < ZOOMED_Y_SIZE; ++y)
+    {
+        for (int x = 0; x < ZOOMED_X_SIZE; ++x)
+        {
+            int color = Grid.at(x, y) ? 0xFFFFFFFF : 0xFF000000;
+            simPutPixel(x, y, color);
+        }
+    }
+}
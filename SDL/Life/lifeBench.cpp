@@ -0,0 +1,246 @@
+#include "hashLife.h"
+#include "lifeEngine.h"
+#include "lifeWorkers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+
+// Checks every engine against the scalar reference and compares their speed.
+// Usage: lifeBench.out [width height generations density%]
+
+namespace
+{
+struct Candidate
+{
+    std::string name;
+    std::function<std::unique_ptr<LifeEngine>(int width, int height)> create;
+    bool bounded = true;
+};
+
+LifeGrid randomSoup(int width, int height, int density)
+{
+    LifeGrid grid(width, height);
+    std::mt19937_64 random(width * 31 + height);
+    for (std::uint8_t& cell : grid.cells)
+    {
+        cell = random() % 100 < static_cast<unsigned>(density);
+    }
+    return grid;
+}
+
+// Steps both engines one generation at a time and compares every generation
+bool matchesReference(
+    LifeEngine& engine,
+    LifeGrid const& start,
+    int generations,
+    LifeRule rule = conwayRule
+)
+{
+    std::unique_ptr<LifeEngine> reference = createScalarEngine(start.width, start.height, rule);
+    reference->load(start);
+    engine.load(start);
+
+    LifeGrid expected(start.width, start.height);
+    LifeGrid actual(start.width, start.height);
+    for (int i = 0; i < generations; ++i)
+    {
+        reference->step(1);
+        engine.step(1);
+        reference->store(expected);
+        engine.store(actual);
+        if (actual != expected)
+        {
+            std::fprintf(stderr, "generation %d differs from the reference\n", i + 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks an unbounded engine on a grid with enough dead margin that nothing reaches the edges,
+// both one generation at a time and in a single jump
+bool matchesReferenceAwayFromEdges(
+    Candidate const& candidate,
+    LifeGrid const& pattern,
+    int generations
+)
+{
+    int margin = generations + 1;
+    LifeGrid start(pattern.width + 2 * margin, pattern.height + 2 * margin);
+    for (int y = 0; y < pattern.height; ++y)
+    {
+        for (int x = 0; x < pattern.width; ++x)
+        {
+            start.at(x + margin, y + margin) = pattern.at(x, y);
+        }
+    }
+    if (!matchesReference(*candidate.create(start.width, start.height), start, generations))
+    {
+        return false;
+    }
+
+    std::unique_ptr<LifeEngine> reference = createScalarEngine(start.width, start.height);
+    std::unique_ptr<LifeEngine> engine = candidate.create(start.width, start.height);
+    reference->load(start);
+    engine->load(start);
+    reference->step(generations);
+    engine->step(generations);
+    LifeGrid expected(start.width, start.height);
+    LifeGrid actual(start.width, start.height);
+    reference->store(expected);
+    engine->store(actual);
+    if (actual != expected)
+    {
+        std::fprintf(stderr, "a jump of %d generations differs from the reference\n", generations);
+        return false;
+    }
+    return true;
+}
+
+double generationsPerSecond(LifeEngine& engine, LifeGrid const& start, int generations)
+{
+    engine.load(start);
+    auto begin = std::chrono::steady_clock::now();
+    engine.step(generations);
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - begin;
+    return generations / seconds.count();
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int width = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int height = argc > 2 ? std::atoi(argv[2]) : 1024;
+    int generations = argc > 3 ? std::atoi(argv[3]) : 100;
+    int density = argc > 4 ? std::atoi(argv[4]) : 30;
+    if (width <= 0 || height <= 0 || generations <= 0)
+    {
+        std::fprintf(stderr, "Usage: %s [width height generations density%%]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Candidate> candidates;
+    for (LifeEngineInfo const& info : lifeEngines())
+    {
+        candidates.push_back({info.name, info.create, info.bounded});
+    }
+    for (std::string const& kernel : simdKernels())
+    {
+        candidates.push_back(
+            {"simd/" + kernel, [kernel](int w, int h) { return createSimdEngine(w, h, kernel); }}
+        );
+    }
+    for (int threads = 2; threads <= lifeThreadCount(); threads *= 2)
+    {
+        candidates.push_back(
+            {"parallel/" + std::to_string(threads),
+             [threads](int w, int h) { return createParallelEngine(w, h, threads); }}
+        );
+    }
+
+    // A small grid with odd dimensions catches mistakes at word and vector edges
+    LifeGrid edges = randomSoup(67, 13, density);
+    LifeGrid soup = randomSoup(width, height, density);
+    double referenceRate = 0;
+    bool allCorrect = true;
+
+    std::printf("%dx%d, %d generations, %d%% alive\n", width, height, generations, density);
+    std::printf(
+        "%-16s %8s %14s %10s %9s\n", "engine", "correct", "generations/s", "cells/ns", "speedup"
+    );
+    for (Candidate const& candidate : candidates)
+    {
+        std::unique_ptr<LifeEngine> engine = candidate.create(width, height);
+        bool correct =
+            candidate.bounded
+                ? matchesReference(*candidate.create(edges.width, edges.height), edges, 200) &&
+                      matchesReference(*engine, soup, std::min(generations, 20))
+                : matchesReferenceAwayFromEdges(candidate, edges, 100);
+        allCorrect = allCorrect && correct;
+
+        double rate = generationsPerSecond(*engine, soup, generations);
+        if (referenceRate == 0)
+        {
+            referenceRate = rate;
+        }
+        std::printf(
+            "%-16s %8s %14.1f %10.3f %8.2fx",
+            candidate.name.c_str(),
+            correct ? "yes" : "NO",
+            rate,
+            rate * width * height * 1e-9,
+            rate / referenceRate
+        );
+        for (LifeMetric const& metric : engine->metrics())
+        {
+            std::printf(" %s=%llu", metric.name, static_cast<unsigned long long>(metric.value));
+        }
+        std::printf("\n");
+    }
+
+    // Named rules run kernels specialised to their masks, any other rule takes the generic path
+    std::vector<NamedLifeRule> rules = namedLifeRules();
+    rules.push_back({"2x2 (generic)", "B36/S125", *findLifeRule("B36/S125")});
+    bool constantsMatch = findLifeRule("conway") == conwayRule &&
+                          findLifeRule("highlife") == highLifeRule &&
+                          findLifeRule("daynight") == dayAndNightRule &&
+                          findLifeRule("seeds") == seedsRule;
+    if (!constantsMatch)
+    {
+        std::printf("\nThe rule constants of lifeRule.h differ from the rules of rule.c\n");
+    }
+    allCorrect = allCorrect && constantsMatch;
+    std::printf(
+        "\n%-16s %-14s %8s %14s %10s\n", "engine", "rule", "correct", "generations/s", "cells/ns"
+    );
+    for (LifeEngineInfo const& info : lifeEngines())
+    {
+        if (!info.createWithRule)
+        {
+            continue;
+        }
+        for (NamedLifeRule const& rule : rules)
+        {
+            std::unique_ptr<LifeEngine> engine = info.createWithRule(width, height, rule.rule);
+            std::unique_ptr<LifeEngine> small =
+                info.createWithRule(edges.width, edges.height, rule.rule);
+            bool correct = matchesReference(*small, edges, 200, rule.rule) &&
+                           matchesReference(*engine, soup, std::min(generations, 20), rule.rule);
+            allCorrect = allCorrect && correct;
+
+            double rate = generationsPerSecond(*engine, soup, generations);
+            std::printf(
+                "%-16s %-14s %8s %14.1f %10.3f %s\n",
+                info.name,
+                rule.rulestring,
+                correct ? "yes" : "NO",
+                rate,
+                rate * width * height * 1e-9,
+                rule.name
+            );
+        }
+    }
+    std::printf("\n");
+
+    // Long horizons are only reachable by HashLife
+    HashLife life(std::size_t(512) << 20);
+    life.load(edges, 0, 0);
+    auto begin = std::chrono::steady_clock::now();
+    life.stepPowerOfTwo(20);
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - begin;
+    std::printf(
+        "hashlife jumped 2^20 generations of a %dx%d soup in %.3f s, population %llu, %zu nodes\n",
+        edges.width,
+        edges.height,
+        seconds.count(),
+        static_cast<unsigned long long>(life.population()),
+        life.nodeCount()
+    );
+
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
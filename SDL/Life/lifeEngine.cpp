@@ -0,0 +1,38 @@
+#include "lifeEngine.h"
+
+std::vector<LifeEngineInfo> const& lifeEngines()
+{
+    static std::vector<LifeEngineInfo> const engines = {
+        {"scalar", createScalarEngine, true, createScalarEngine},
+        {"app", createAppEngine, true, createAppEngine},
+        {"bitpacked", createBitPackedEngine, true, createBitPackedEngine},
+        {"blocktable", createBlockTableEngine, true, createBlockTableEngine},
+        {"simd", createSimdEngine},
+        {"parallel", createParallelEngine},
+        {"tiled", createTiledEngine, true, createTiledEngine},
+        {"hashlife", createHashLifeEngine, false},
+    };
+    return engines;
+}
+
+std::unique_ptr<LifeEngine> createLifeEngine(
+    std::string const& name,
+    int width,
+    int height,
+    LifeRule rule
+)
+{
+    for (LifeEngineInfo const& engine : lifeEngines())
+    {
+        if (name != engine.name)
+        {
+            continue;
+        }
+        if (rule == conwayRule)
+        {
+            return engine.create(width, height);
+        }
+        return engine.createWithRule ? engine.createWithRule(width, height, rule) : nullptr;
+    }
+    return nullptr;
+}
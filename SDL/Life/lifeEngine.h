@@ -0,0 +1,111 @@
+#pragma once
+
+#include "lifeRule.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Byte-per-cell grid used to move states in and out of engines.
+// Cells outside the grid are dead, as in app.c.
+struct LifeGrid
+{
+    int width;
+    int height;
+    std::vector<std::uint8_t> cells;
+
+    LifeGrid(int width, int height)
+        : width(width)
+        , height(height)
+        , cells(static_cast<std::size_t>(width) * height)
+    {
+    }
+
+    std::uint8_t& at(int x, int y)
+    {
+        return cells[static_cast<std::size_t>(y) * width + x];
+    }
+
+    std::uint8_t at(int x, int y) const
+    {
+        return cells[static_cast<std::size_t>(y) * width + x];
+    }
+
+    bool operator==(LifeGrid const&) const = default;
+};
+
+struct LifeMetric
+{
+    char const* name;
+    std::uint64_t value;
+};
+
+class LifeEngine
+{
+  public:
+    virtual ~LifeEngine() = default;
+
+    virtual void load(LifeGrid const& grid) = 0;
+    virtual void store(LifeGrid& grid) const = 0;
+    virtual void step(std::uint64_t generations) = 0;
+
+    // Engine-specific counters describing the last generation
+    virtual std::vector<LifeMetric> metrics() const
+    {
+        return {};
+    }
+};
+
+struct LifeEngineInfo
+{
+    char const* name;
+    std::unique_ptr<LifeEngine> (*create)(int width, int height);
+    // Unbounded engines show a window of an infinite universe instead of a grid with dead
+    // edges, so they agree with the reference only while patterns stay clear of the edges
+    bool bounded = true;
+    // Set for engines that can run rules other than Conway's
+    std::unique_ptr<LifeEngine> (*createWithRule)(int width, int height, LifeRule rule) = nullptr;
+};
+
+// Engines run Conway's B3/S23 unless they are created with a rule
+std::unique_ptr<LifeEngine> createScalarEngine(int width, int height);
+std::unique_ptr<LifeEngine> createScalarEngine(int width, int height, LifeRule rule);
+// Runs lifeStep, the ghost-border byte kernel app.c steps with
+std::unique_ptr<LifeEngine> createAppEngine(int width, int height);
+std::unique_ptr<LifeEngine> createAppEngine(int width, int height, LifeRule rule);
+std::unique_ptr<LifeEngine> createBitPackedEngine(int width, int height);
+std::unique_ptr<LifeEngine> createBitPackedEngine(int width, int height, LifeRule rule);
+// Uses the widest kernel the CPU supports, or the one named in LIFE_SIMD
+std::unique_ptr<LifeEngine> createSimdEngine(int width, int height);
+
+// Returns nullptr if the CPU does not support the kernel
+std::unique_ptr<LifeEngine> createSimdEngine(int width, int height, std::string const& kernel);
+// Kernels the CPU supports, widest first
+std::vector<std::string> simdKernels();
+
+// The simd engine stepping bands of rows on LIFE_THREADS threads (all hardware threads by default)
+std::unique_ptr<LifeEngine> createParallelEngine(int width, int height);
+std::unique_ptr<LifeEngine> createParallelEngine(int width, int height, int threads);
+
+// Looks up the next 2x2 block of every 4x4 neighbourhood in a 64K-entry table
+std::unique_ptr<LifeEngine> createBlockTableEngine(int width, int height);
+std::unique_ptr<LifeEngine> createBlockTableEngine(int width, int height, LifeRule rule);
+
+// Steps only the 64 x 64 tiles where something happened in the previous generation
+std::unique_ptr<LifeEngine> createTiledEngine(int width, int height);
+std::unique_ptr<LifeEngine> createTiledEngine(int width, int height, LifeRule rule);
+
+// Unbounded, the grid is the window [0, width) x [0, height) of the universe.
+// LIFE_HASHLIFE_MB sets the node table memory budget (512 MiB by default)
+std::unique_ptr<LifeEngine> createHashLifeEngine(int width, int height);
+
+std::vector<LifeEngineInfo> const& lifeEngines();
+
+// Returns nullptr for unknown engine names and for engines that cannot run the rule
+std::unique_ptr<LifeEngine> createLifeEngine(
+    std::string const& name,
+    int width,
+    int height,
+    LifeRule rule = conwayRule
+);
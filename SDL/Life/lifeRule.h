@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../rule.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Outer-totalistic rule: bit n of birth is set when a dead cell with n live neighbours is born,
+// bit n of survival when a live cell with n live neighbours stays alive
+struct LifeRule
+{
+    std::uint16_t birth = 0;
+    std::uint16_t survival = 0;
+
+    constexpr bool next(bool alive, int neighbours) const
+    {
+        return (alive ? survival : birth) >> neighbours & 1;
+    }
+
+    bool operator==(LifeRule const&) const = default;
+};
+
+// Masks of the rules named in rule.c, spelled out because templates need them at compile time.
+// lifeBench checks them against the parsed rules
+inline constexpr LifeRule conwayRule = {1 << 3, 1 << 2 | 1 << 3};
+inline constexpr LifeRule highLifeRule = {1 << 3 | 1 << 6, 1 << 2 | 1 << 3};
+inline constexpr LifeRule dayAndNightRule = {
+    1 << 3 | 1 << 6 | 1 << 7 | 1 << 8,
+    1 << 3 | 1 << 4 | 1 << 6 | 1 << 7 | 1 << 8
+};
+inline constexpr LifeRule seedsRule = {1 << 2, 0};
+
+struct NamedLifeRule
+{
+    char const* name;
+    char const* rulestring;
+    LifeRule rule;
+};
+
+constexpr LifeRule toLifeRule(Rule rule)
+{
+    return {static_cast<std::uint16_t>(rule.birth), static_cast<std::uint16_t>(rule.survival)};
+}
+
+// Accepts the names and rulestrings ruleParse from rule.h does, which is the only parser
+inline std::optional<LifeRule> findLifeRule(char const* name)
+{
+    Rule rule;
+    if (ruleParse(name, &rule) != 0)
+    {
+        return std::nullopt;
+    }
+    return toLifeRule(rule);
+}
+
+// The named rules of rule.c with their parsed masks
+inline std::vector<NamedLifeRule> namedLifeRules()
+{
+    std::vector<NamedLifeRule> rules;
+    for (NamedRule const* named = NamedRules; named->name; ++named)
+    {
+        rules.push_back({named->name, named->rulestring, *findLifeRule(named->rulestring)});
+    }
+    return rules;
+}
+
+// A rule known at compile time, for code specialised to its masks
+template <LifeRule rule>
+struct LifeRuleConstant
+{
+    static constexpr LifeRule value = rule;
+
+    constexpr operator LifeRule() const
+    {
+        return rule;
+    }
+};
+
+// Calls visit with a LifeRuleConstant for each of the named rules, so their masks are compiled
+// into the kernels, and with the LifeRule itself for any other rule
+template <class Visitor>
+auto visitLifeRule(LifeRule rule, Visitor&& visit)
+{
+    if (rule == conwayRule)
+    {
+        return visit(LifeRuleConstant<conwayRule>{});
+    }
+    if (rule == highLifeRule)
+    {
+        return visit(LifeRuleConstant<highLifeRule>{});
+    }
+    if (rule == dayAndNightRule)
+    {
+        return visit(LifeRuleConstant<dayAndNightRule>{});
+    }
+    if (rule == seedsRule)
+    {
+        return visit(LifeRuleConstant<seedsRule>{});
+    }
+    return visit(rule);
+}
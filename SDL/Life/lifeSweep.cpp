@@ -0,0 +1,393 @@
+#include "lifeEngine.h"
+#include "lifeWorkers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Measures the step of every engine over a matrix of grid sizes, densities and thread counts
+// and prints one CSV row per case, so runs of different commits can be compared line by line.
+// Every case runs in a child process, which gives it a clean heap and its own peak RSS.
+// Usage: lifeSweep.out [--sizes WxH,...] [--densities %,...] [--threads N,...]
+//                      [--engines name,...] [--repetitions N] [--min-time seconds]
+//                      [--label text]
+
+namespace
+{
+// HashLife jumps take about as long for any distance, so calibration has to stop somewhere
+constexpr std::uint64_t MAX_GENERATIONS = 1 << 16;
+
+struct Options
+{
+    std::vector<std::pair<int, int>> sizes = {
+        {64, 32},
+        {256, 256},
+        {1024, 1024},
+        {4096, 4096},
+        {16384, 16384},
+    };
+    std::vector<int> densities = {10, 30, 50};
+    std::vector<int> threads;
+    // Empty runs every engine
+    std::vector<std::string> engines;
+    int repetitions = 5;
+    // Warm-up doubles the generations of a repetition until it lasts at least this long
+    double minSeconds = 0.2;
+    std::string label = "-";
+};
+
+struct Case
+{
+    std::string engine;
+    int threads;
+    std::function<std::unique_ptr<LifeEngine>(int width, int height)> create;
+};
+
+// Written by the child process into a pipe
+struct Result
+{
+    std::uint64_t generations;
+    int repetitions;
+    double mean;
+    double deviation;
+    double minimum;
+    double maximum;
+};
+
+std::vector<std::string> splitList(char const* list)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (char const* c = list;; ++c)
+    {
+        if (*c == ',' || *c == '\0')
+        {
+            if (!item.empty())
+            {
+                items.push_back(item);
+            }
+            item.clear();
+            if (*c == '\0')
+            {
+                return items;
+            }
+        }
+        else
+        {
+            item += *c;
+        }
+    }
+}
+
+std::vector<int> parseNumbers(char const* list)
+{
+    std::vector<int> numbers;
+    for (std::string const& item : splitList(list))
+    {
+        numbers.push_back(std::atoi(item.c_str()));
+    }
+    return numbers;
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i += 2)
+    {
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+        char const* name = argv[i];
+        char const* value = argv[i + 1];
+        if (std::strcmp(name, "--sizes") == 0)
+        {
+            options.sizes.clear();
+            for (std::string const& size : splitList(value))
+            {
+                int width = 0;
+                int height = 0;
+                if (std::sscanf(size.c_str(), "%dx%d", &width, &height) != 2 || width <= 0 ||
+                    height <= 0)
+                {
+                    return false;
+                }
+                options.sizes.push_back({width, height});
+            }
+        }
+        else if (std::strcmp(name, "--densities") == 0)
+        {
+            options.densities = parseNumbers(value);
+        }
+        else if (std::strcmp(name, "--threads") == 0)
+        {
+            options.threads = parseNumbers(value);
+        }
+        else if (std::strcmp(name, "--engines") == 0)
+        {
+            options.engines = splitList(value);
+        }
+        else if (std::strcmp(name, "--repetitions") == 0)
+        {
+            options.repetitions = std::atoi(value);
+        }
+        else if (std::strcmp(name, "--min-time") == 0)
+        {
+            options.minSeconds = std::atof(value);
+        }
+        else if (std::strcmp(name, "--label") == 0)
+        {
+            options.label = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.repetitions > 0 && !options.sizes.empty() && !options.densities.empty();
+}
+
+// Powers of two up to every hardware thread, and the hardware thread count itself
+std::vector<int> defaultThreadCounts()
+{
+    std::vector<int> counts;
+    int hardware = lifeThreadCount();
+    for (int threads = 1; threads < hardware; threads *= 2)
+    {
+        counts.push_back(threads);
+    }
+    counts.push_back(hardware);
+    return counts;
+}
+
+std::vector<Case> listCases(Options const& options)
+{
+    std::vector<Case> cases;
+    for (LifeEngineInfo const& info : lifeEngines())
+    {
+        if (std::strcmp(info.name, "parallel") == 0)
+        {
+            for (int threads : options.threads)
+            {
+                cases.push_back(
+                    {info.name,
+                     threads,
+                     [threads](int w, int h) { return createParallelEngine(w, h, threads); }}
+                );
+            }
+            continue;
+        }
+        if (std::strcmp(info.name, "simd") == 0)
+        {
+            for (std::string const& kernel : simdKernels())
+            {
+                cases.push_back(
+                    {"simd/" + kernel,
+                     1,
+                     [kernel](int w, int h) { return createSimdEngine(w, h, kernel); }}
+                );
+            }
+            continue;
+        }
+        cases.push_back({info.name, 1, info.create});
+    }
+
+    if (!options.engines.empty())
+    {
+        std::erase_if(
+            cases,
+            [&](Case const& c)
+            {
+                std::string family = c.engine.substr(0, c.engine.find('/'));
+                return std::find(options.engines.begin(), options.engines.end(), c.engine) ==
+                           options.engines.end() &&
+                       std::find(options.engines.begin(), options.engines.end(), family) ==
+                           options.engines.end();
+            }
+        );
+    }
+    return cases;
+}
+
+LifeGrid randomSoup(int width, int height, int density)
+{
+    LifeGrid grid(width, height);
+    std::mt19937_64 random(width * 31 + height);
+    for (std::uint8_t& cell : grid.cells)
+    {
+        cell = random() % 100 < static_cast<unsigned>(density);
+    }
+    return grid;
+}
+
+double secondsToStep(LifeEngine& engine, LifeGrid const& start, std::uint64_t generations)
+{
+    engine.load(start);
+    auto begin = std::chrono::steady_clock::now();
+    engine.step(generations);
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - begin;
+    return seconds.count();
+}
+
+// Every repetition starts from the same soup, so the repetitions measure the same work
+Result measure(Case const& c, int width, int height, int density, Options const& options)
+{
+    LifeGrid soup = randomSoup(width, height, density);
+    std::unique_ptr<LifeEngine> engine = c.create(width, height);
+
+    // Warm-up faults the grids in, starts the worker threads and calibrates the repetitions
+    std::uint64_t generations = 1;
+    while (secondsToStep(*engine, soup, generations) < options.minSeconds &&
+           generations < MAX_GENERATIONS)
+    {
+        generations *= 2;
+    }
+
+    std::vector<double> rates;
+    for (int i = 0; i < options.repetitions; ++i)
+    {
+        rates.push_back(generations / secondsToStep(*engine, soup, generations));
+    }
+
+    Result result = {generations, options.repetitions, 0, 0, rates[0], rates[0]};
+    for (double rate : rates)
+    {
+        result.mean += rate / rates.size();
+        result.minimum = std::min(result.minimum, rate);
+        result.maximum = std::max(result.maximum, rate);
+    }
+    for (double rate : rates)
+    {
+        result.deviation += (rate - result.mean) * (rate - result.mean);
+    }
+    result.deviation =
+        rates.size() > 1 ? std::sqrt(result.deviation / (rates.size() - 1)) : 0.0;
+    return result;
+}
+
+// Returns false if the child failed, the peak RSS of the child is in KiB
+bool measureInChild(
+    Case const& c,
+    int width,
+    int height,
+    int density,
+    Options const& options,
+    Result& result,
+    long& peakKilobytes
+)
+{
+    int channel[2];
+    if (pipe(channel) != 0)
+    {
+        std::perror("pipe");
+        return false;
+    }
+
+    std::fflush(nullptr);
+    pid_t child = fork();
+    if (child < 0)
+    {
+        std::perror("fork");
+        return false;
+    }
+    if (child == 0)
+    {
+        close(channel[0]);
+        Result measured = measure(c, width, height, density, options);
+        bool written = write(channel[1], &measured, sizeof(measured)) == sizeof(measured);
+        _exit(written ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(channel[1]);
+    bool received = read(channel[0], &result, sizeof(result)) == sizeof(result);
+    close(channel[0]);
+
+    int status = 0;
+    rusage usage = {};
+    wait4(child, &status, 0, &usage);
+    peakKilobytes = usage.ru_maxrss;
+    return received && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::fprintf(
+            stderr,
+            "Usage: %s [--sizes WxH,...] [--densities %%,...] [--threads N,...] "
+            "[--engines name,...] [--repetitions N] [--min-time seconds] [--label text]\n",
+            argv[0]
+        );
+        return EXIT_FAILURE;
+    }
+    if (options.threads.empty())
+    {
+        options.threads = defaultThreadCounts();
+    }
+
+    std::vector<Case> cases = listCases(options);
+    bool allMeasured = true;
+
+    std::printf(
+        "label,engine,threads,width,height,density,generations,repetitions,"
+        "generations_per_s_mean,generations_per_s_stddev,generations_per_s_min,"
+        "generations_per_s_max,cells_per_ns_mean,peak_rss_kib\n"
+    );
+    for (auto [width, height] : options.sizes)
+    {
+        for (int density : options.densities)
+        {
+            for (Case const& c : cases)
+            {
+                std::fprintf(
+                    stderr,
+                    "[sweep] %s/%d %dx%d %d%%\n",
+                    c.engine.c_str(),
+                    c.threads,
+                    width,
+                    height,
+                    density
+                );
+
+                Result result;
+                long peakKilobytes = 0;
+                if (!measureInChild(c, width, height, density, options, result, peakKilobytes))
+                {
+                    std::fprintf(stderr, "[sweep] %s failed\n", c.engine.c_str());
+                    allMeasured = false;
+                    continue;
+                }
+                std::printf(
+                    "%s,%s,%d,%d,%d,%d,%llu,%d,%.3f,%.3f,%.3f,%.3f,%.4f,%ld\n",
+                    options.label.c_str(),
+                    c.engine.c_str(),
+                    c.threads,
+                    width,
+                    height,
+                    density,
+                    static_cast<unsigned long long>(result.generations),
+                    result.repetitions,
+                    result.mean,
+                    result.deviation,
+                    result.minimum,
+                    result.maximum,
+                    result.mean * width * height * 1e-9,
+                    peakKilobytes
+                );
+                std::fflush(stdout);
+            }
+        }
+    }
+    return allMeasured ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,97 @@
+#include "lifeWorkers.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+LifeWorkerPool::LifeWorkerPool(int threads)
+    : slices(std::make_unique<Slice[]>(std::max(threads, 1)))
+{
+    for (int worker = 1; worker < threads; ++worker)
+    {
+        workers.emplace_back([this, worker] { work(worker); });
+    }
+}
+
+LifeWorkerPool::~LifeWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    started.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void LifeWorkerPool::run(int tasks, std::function<void(int)> const& loopTask)
+{
+    int count = threads();
+    for (int worker = 0; worker < count; ++worker)
+    {
+        slices[worker].next.store(tasks * worker / count, std::memory_order_relaxed);
+        slices[worker].end = tasks * (worker + 1) / count;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &loopTask;
+        busy = count - 1;
+        ++loop;
+    }
+    started.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busy == 0; });
+    task = nullptr;
+}
+
+void LifeWorkerPool::work(int worker)
+{
+    std::uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            started.wait(lock, [&] { return stopping || loop != seen; });
+            if (stopping)
+            {
+                return;
+            }
+            seen = loop;
+        }
+
+        drain(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+        {
+            finished.notify_one();
+        }
+    }
+}
+
+void LifeWorkerPool::drain(int worker)
+{
+    int count = threads();
+    for (int i = 0; i < count; ++i)
+    {
+        Slice& slice = slices[(worker + i) % count];
+        int index;
+        while ((index = slice.next.fetch_add(1, std::memory_order_relaxed)) < slice.end)
+        {
+            (*task)(index);
+        }
+    }
+}
+
+int lifeThreadCount()
+{
+    char const* threads = std::getenv("LIFE_THREADS");
+    int count = threads ? std::atoi(threads)
+                        : static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(count, 1);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent threads that share the tasks of one parallel loop at a time.
+// Each thread starts with a contiguous slice of the tasks and steals from the slices
+// of other threads once its own is done; run() returns after all tasks are done,
+// which is the only synchronisation point of a loop.
+class LifeWorkerPool
+{
+  public:
+    // The calling thread is one of the workers, so threads - 1 threads are started
+    explicit LifeWorkerPool(int threads);
+    ~LifeWorkerPool();
+
+    LifeWorkerPool(LifeWorkerPool const&) = delete;
+    LifeWorkerPool& operator=(LifeWorkerPool const&) = delete;
+
+    int threads() const
+    {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+    void run(int tasks, std::function<void(int)> const& task);
+
+  private:
+    struct alignas(64) Slice
+    {
+        std::atomic<int> next;
+        int end;
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Slice[]> slices;
+
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    std::function<void(int)> const* task = nullptr;
+    std::uint64_t loop = 0;
+    int busy = 0;
+    bool stopping = false;
+
+    void work(int worker);
+    void drain(int worker);
+};
+
+// LIFE_THREADS, or every hardware thread when it is not set
+int lifeThreadCount();
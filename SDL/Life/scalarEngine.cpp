@@ -0,0 +1,84 @@
+#include "lifeEngine.h"
+
+#include <utility>
+
+namespace
+{
+// The original bounds-checked generation loop of app.c, kept as the reference for every other
+// engine
+class ScalarEngine : public LifeEngine
+{
+  public:
+    ScalarEngine(int width, int height, LifeRule rule)
+        : width(width)
+        , height(height)
+        , rule(rule)
+        , currentlyAlive(static_cast<std::size_t>(width) * height)
+        , nextAlive(static_cast<std::size_t>(width) * height)
+    {
+    }
+
+    void load(LifeGrid const& grid) override
+    {
+        currentlyAlive.assign(grid.cells.begin(), grid.cells.end());
+    }
+
+    void store(LifeGrid& grid) const override
+    {
+        grid.cells.assign(currentlyAlive.begin(), currentlyAlive.end());
+    }
+
+    void step(std::uint64_t generations) override
+    {
+        for (std::uint64_t i = 0; i < generations; ++i)
+        {
+            stepOnce();
+            std::swap(currentlyAlive, nextAlive);
+        }
+    }
+
+  private:
+    int width;
+    int height;
+    LifeRule rule;
+    std::vector<int> currentlyAlive;
+    std::vector<int> nextAlive;
+
+    int cell(int x, int y) const
+    {
+        return currentlyAlive[static_cast<std::size_t>(y) * width + x];
+    }
+
+    void stepOnce()
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                int alive_neighbors = 0;
+                alive_neighbors += (x > 0) && (y > 0) && cell(x - 1, y - 1);
+                alive_neighbors += (y > 0) && cell(x, y - 1);
+                alive_neighbors += (x < width - 1) && (y > 0) && cell(x + 1, y - 1);
+                alive_neighbors += (x < width - 1) && cell(x + 1, y);
+                alive_neighbors += (x < width - 1) && (y < height - 1) && cell(x + 1, y + 1);
+                alive_neighbors += (y < height - 1) && cell(x, y + 1);
+                alive_neighbors += (x > 0) && (y < height - 1) && cell(x - 1, y + 1);
+                alive_neighbors += (x > 0) && cell(x - 1, y);
+
+                nextAlive[static_cast<std::size_t>(y) * width + x] =
+                    rule.next(cell(x, y), alive_neighbors);
+            }
+        }
+    }
+};
+} // namespace
+
+std::unique_ptr<LifeEngine> createScalarEngine(int width, int height)
+{
+    return createScalarEngine(width, height, conwayRule);
+}
+
+std::unique_ptr<LifeEngine> createScalarEngine(int width, int height, LifeRule rule)
+{
+    return std::make_unique<ScalarEngine>(width, height, rule);
+}
@@ -0,0 +1,324 @@
+#include "lifeEngine.h"
+#include "lifeWorkers.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LIFE_SIMD_X86
+#endif
+
+namespace
+{
+// Byte-per-cell rows framed by a dead column on the left and at least one vector of dead
+// columns on the right, with a dead row above and below, so the kernels load the eight
+// neighbours of a whole vector of cells without any bounds checks.
+// Kernels step every row in blocks of 64 cells; cells past the width are cleared afterwards.
+constexpr int BLOCK = 64;
+
+// With several threads the rows are stepped in bands of about this many bytes, small enough
+// for a band and its two halo rows to stay in L2 and numerous enough to balance the load
+constexpr int BAND_BYTES = 32 * 1024;
+
+using Kernel = void (*)(std::uint8_t const* current, std::uint8_t* next, int stride, int blocks);
+
+void stepRowScalar(std::uint8_t const* current, std::uint8_t* next, int stride, int blocks)
+{
+    std::uint8_t const* above = current - stride;
+    std::uint8_t const* below = current + stride;
+    for (int x = 0; x < blocks * BLOCK; ++x)
+    {
+        int neighbours = above[x - 1] + above[x] + above[x + 1] + current[x - 1] +
+                         current[x + 1] + below[x - 1] + below[x] + below[x + 1];
+        next[x] = neighbours == 3 || (neighbours == 2 && current[x]);
+    }
+}
+
+#ifdef LIFE_SIMD_X86
+__attribute__((target("sse2"))) inline __m128i load128(std::uint8_t const* cells)
+{
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(cells));
+}
+
+__attribute__((target("avx2"))) inline __m256i load256(std::uint8_t const* cells)
+{
+    return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(cells));
+}
+
+__attribute__((target("avx512f,avx512bw"))) inline __m512i load512(std::uint8_t const* cells)
+{
+    return _mm512_loadu_si512(cells);
+}
+
+__attribute__((target("sse2"))) void
+stepRowSse2(std::uint8_t const* current, std::uint8_t* next, int stride, int blocks)
+{
+    __m128i const three = _mm_set1_epi8(3);
+    __m128i const one = _mm_set1_epi8(1);
+    std::uint8_t const* above = current - stride;
+    std::uint8_t const* below = current + stride;
+    for (int x = 0; x < blocks * BLOCK; x += 16)
+    {
+        __m128i self = load128(current + x);
+        __m128i neighbours = _mm_add_epi8(
+            _mm_add_epi8(
+                _mm_add_epi8(load128(above + x - 1), load128(above + x)),
+                _mm_add_epi8(load128(above + x + 1), load128(current + x - 1))
+            ),
+            _mm_add_epi8(
+                _mm_add_epi8(load128(current + x + 1), load128(below + x - 1)),
+                _mm_add_epi8(load128(below + x), load128(below + x + 1))
+            )
+        );
+        // Alive with 3 neighbours, or alive already with 2: (neighbours | self) == 3
+        __m128i alive = _mm_cmpeq_epi8(_mm_or_si128(neighbours, self), three);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(next + x), _mm_and_si128(alive, one));
+    }
+}
+
+__attribute__((target("avx2"))) void
+stepRowAvx2(std::uint8_t const* current, std::uint8_t* next, int stride, int blocks)
+{
+    __m256i const three = _mm256_set1_epi8(3);
+    __m256i const one = _mm256_set1_epi8(1);
+    std::uint8_t const* above = current - stride;
+    std::uint8_t const* below = current + stride;
+    for (int x = 0; x < blocks * BLOCK; x += 32)
+    {
+        __m256i self = load256(current + x);
+        __m256i neighbours = _mm256_add_epi8(
+            _mm256_add_epi8(
+                _mm256_add_epi8(load256(above + x - 1), load256(above + x)),
+                _mm256_add_epi8(load256(above + x + 1), load256(current + x - 1))
+            ),
+            _mm256_add_epi8(
+                _mm256_add_epi8(load256(current + x + 1), load256(below + x - 1)),
+                _mm256_add_epi8(load256(below + x), load256(below + x + 1))
+            )
+        );
+        __m256i alive = _mm256_cmpeq_epi8(_mm256_or_si256(neighbours, self), three);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(next + x), _mm256_and_si256(alive, one));
+    }
+}
+
+__attribute__((target("avx512f,avx512bw"))) void
+stepRowAvx512(std::uint8_t const* current, std::uint8_t* next, int stride, int blocks)
+{
+    __m512i const three = _mm512_set1_epi8(3);
+    __m512i const one = _mm512_set1_epi8(1);
+    std::uint8_t const* above = current - stride;
+    std::uint8_t const* below = current + stride;
+    for (int x = 0; x < blocks * BLOCK; x += 64)
+    {
+        __m512i self = load512(current + x);
+        __m512i neighbours = _mm512_add_epi8(
+            _mm512_add_epi8(
+                _mm512_add_epi8(load512(above + x - 1), load512(above + x)),
+                _mm512_add_epi8(load512(above + x + 1), load512(current + x - 1))
+            ),
+            _mm512_add_epi8(
+                _mm512_add_epi8(load512(current + x + 1), load512(below + x - 1)),
+                _mm512_add_epi8(load512(below + x), load512(below + x + 1))
+            )
+        );
+        __mmask64 alive = _mm512_cmpeq_epi8_mask(_mm512_or_si512(neighbours, self), three);
+        _mm512_storeu_si512(next + x, _mm512_maskz_mov_epi8(alive, one));
+    }
+}
+#endif
+
+struct KernelInfo
+{
+    char const* name;
+    Kernel kernel;
+    bool (*supported)();
+};
+
+KernelInfo const Kernels[] = {
+#ifdef LIFE_SIMD_X86
+    {"avx512", stepRowAvx512, [] { return __builtin_cpu_supports("avx512bw") != 0; }},
+    {"avx2", stepRowAvx2, [] { return __builtin_cpu_supports("avx2") != 0; }},
+    {"sse2", stepRowSse2, [] { return __builtin_cpu_supports("sse2") != 0; }},
+#endif
+    {"scalar", stepRowScalar, [] { return true; }},
+};
+
+KernelInfo const* findKernel(std::string const& name)
+{
+    for (KernelInfo const& info : Kernels)
+    {
+        if (name == info.name && info.supported())
+        {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+// Picks the widest kernel the CPU supports, unless LIFE_SIMD names another one
+KernelInfo const& selectKernel()
+{
+    char const* requested = std::getenv("LIFE_SIMD");
+    if (requested)
+    {
+        KernelInfo const* info = findKernel(requested);
+        if (!info)
+        {
+            std::fprintf(
+                stderr,
+                "[simd] Unknown LIFE_SIMD '%s', or one this CPU does not support; it supports",
+                requested
+            );
+            for (std::string const& name : simdKernels())
+            {
+                std::fprintf(stderr, " %s", name.c_str());
+            }
+            std::fprintf(stderr, "\n");
+            std::exit(EXIT_FAILURE);
+        }
+        return *info;
+    }
+    for (KernelInfo const& info : Kernels)
+    {
+        if (info.supported())
+        {
+            return info;
+        }
+    }
+    std::abort();
+}
+
+class SimdEngine : public LifeEngine
+{
+  public:
+    SimdEngine(int width, int height, Kernel kernel, int threads)
+        : width(width)
+        , height(height)
+        , blocks((width + BLOCK - 1) / BLOCK)
+        , stride(blocks * BLOCK + BLOCK)
+        , bandRows(std::max(BAND_BYTES / stride, 1))
+        , kernel(kernel)
+        , current(static_cast<std::size_t>(stride) * (height + 2))
+        , next(static_cast<std::size_t>(stride) * (height + 2))
+    {
+        if (threads > 1)
+        {
+            workers = std::make_unique<LifeWorkerPool>(threads);
+        }
+    }
+
+    void load(LifeGrid const& grid) override
+    {
+        std::fill(current.begin(), current.end(), 0);
+        for (int y = 0; y < height; ++y)
+        {
+            std::uint8_t* row = rowCells(current, y);
+            for (int x = 0; x < width; ++x)
+            {
+                row[x] = grid.at(x, y) != 0;
+            }
+        }
+    }
+
+    void store(LifeGrid& grid) const override
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            std::copy_n(rowCells(current, y), width, &grid.at(0, y));
+        }
+    }
+
+    void step(std::uint64_t generations) override
+    {
+        int bands = (height + bandRows - 1) / bandRows;
+        for (std::uint64_t i = 0; i < generations; ++i)
+        {
+            // Halo rows are read straight from the neighbouring bands of the current generation,
+            // which nobody writes until the next one
+            if (workers)
+            {
+                workers->run(bands, [&](int band) { stepBand(band); });
+            }
+            else
+            {
+                stepRows(0, height);
+            }
+            std::swap(current, next);
+        }
+    }
+
+  private:
+    int width;
+    int height;
+    int blocks;
+    int stride;
+    int bandRows;
+    Kernel kernel;
+    std::vector<std::uint8_t> current;
+    std::vector<std::uint8_t> next;
+    std::unique_ptr<LifeWorkerPool> workers;
+
+    void stepRows(int begin, int end)
+    {
+        for (int y = begin; y < end; ++y)
+        {
+            std::uint8_t* row = rowCells(next, y);
+            kernel(rowCells(current, y), row, stride, blocks);
+            std::fill(row + width, row + blocks * BLOCK, 0);
+        }
+    }
+
+    void stepBand(int band)
+    {
+        stepRows(band * bandRows, std::min((band + 1) * bandRows, height));
+    }
+
+    std::uint8_t* rowCells(std::vector<std::uint8_t>& cells, int y)
+    {
+        return cells.data() + static_cast<std::size_t>(y + 1) * stride + 1;
+    }
+
+    std::uint8_t const* rowCells(std::vector<std::uint8_t> const& cells, int y) const
+    {
+        return cells.data() + static_cast<std::size_t>(y + 1) * stride + 1;
+    }
+};
+} // namespace
+
+std::unique_ptr<LifeEngine> createSimdEngine(int width, int height)
+{
+    return std::make_unique<SimdEngine>(width, height, selectKernel().kernel, 1);
+}
+
+std::unique_ptr<LifeEngine> createSimdEngine(int width, int height, std::string const& kernel)
+{
+    KernelInfo const* info = findKernel(kernel);
+    return info ? std::make_unique<SimdEngine>(width, height, info->kernel, 1) : nullptr;
+}
+
+std::unique_ptr<LifeEngine> createParallelEngine(int width, int height)
+{
+    return createParallelEngine(width, height, lifeThreadCount());
+}
+
+std::unique_ptr<LifeEngine> createParallelEngine(int width, int height, int threads)
+{
+    return std::make_unique<SimdEngine>(width, height, selectKernel().kernel, threads);
+}
+
+std::vector<std::string> simdKernels()
+{
+    std::vector<std::string> names;
+    for (KernelInfo const& info : Kernels)
+    {
+        if (info.supported())
+        {
+            names.push_back(info.name);
+        }
+    }
+    return names;
+}
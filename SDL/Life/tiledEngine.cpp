@@ -0,0 +1,215 @@
+#include "bitSlice.h"
+#include "lifeEngine.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+using Word = std::uint64_t;
+
+// Tiles are 64 x 64 cells, one word per tile row
+constexpr int TILE = 64;
+
+// Steps only the tiles that changed in the previous generation and their neighbours.
+// Every tile keeps two generations; a tile that is not stepped did not change when it was
+// last stepped, so both of its generations are equal and it can sit out any number of
+// generations. Cells past the edges of the grid are kept dead.
+class TiledEngine : public LifeEngine
+{
+  public:
+    TiledEngine(int width, int height, LifeRule rule)
+        : width(width)
+        , height(height)
+        , rule(rule)
+        , tilesX((width + TILE - 1) / TILE)
+        , tilesY((height + TILE - 1) / TILE)
+        , tiles(static_cast<std::size_t>(tilesX) * tilesY)
+        , scheduled(tiles.size())
+    {
+    }
+
+    void load(LifeGrid const& grid) override
+    {
+        active.clear();
+        for (int id = 0; id < static_cast<int>(tiles.size()); ++id)
+        {
+            Tile& tile = tiles[id];
+            for (int row = 0; row < TILE; ++row)
+            {
+                int y = id / tilesX * TILE + row;
+                Word word = 0;
+                for (int bit = 0; bit < TILE && y < height; ++bit)
+                {
+                    int x = id % tilesX * TILE + bit;
+                    word |= Word(x < width && grid.at(x, y) != 0) << bit;
+                }
+                tile.rows[0][row] = word;
+                tile.rows[1][row] = word;
+            }
+            active.push_back(id);
+        }
+    }
+
+    void store(LifeGrid& grid) const override
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                Tile const& tile = tiles[y / TILE * tilesX + x / TILE];
+                grid.at(x, y) = tile.rows[parity][y % TILE] >> x % TILE & 1;
+            }
+        }
+    }
+
+    void step(std::uint64_t generations) override
+    {
+        visitLifeRule(
+            rule,
+            [&](auto kernelRule)
+            {
+                for (std::uint64_t i = 0; i < generations; ++i)
+                {
+                    for (int id : active)
+                    {
+                        if (stepTile(id, kernelRule))
+                        {
+                            scheduleAround(id);
+                        }
+                    }
+                    for (int id : nextActive)
+                    {
+                        scheduled[id] = 0;
+                    }
+
+                    lastActive = active.size();
+                    std::swap(active, nextActive);
+                    nextActive.clear();
+                    parity ^= 1;
+                }
+            }
+        );
+    }
+
+    std::vector<LifeMetric> metrics() const override
+    {
+        return {{"active_tiles", lastActive}};
+    }
+
+  private:
+    struct Tile
+    {
+        Word rows[2][TILE];
+    };
+
+    int width;
+    int height;
+    LifeRule rule;
+    int tilesX;
+    int tilesY;
+    std::vector<Tile> tiles;
+    int parity = 0;
+
+    std::vector<int> active;
+    std::vector<int> nextActive;
+    std::vector<std::uint8_t> scheduled;
+    std::uint64_t lastActive = 0;
+
+    Word const* tileRows(int tileX, int tileY) const
+    {
+        if (tileX < 0 || tileX >= tilesX || tileY < 0 || tileY >= tilesY)
+        {
+            return nullptr;
+        }
+        return tiles[static_cast<std::size_t>(tileY) * tilesX + tileX].rows[parity];
+    }
+
+    void scheduleAround(int id)
+    {
+        int tileX = id % tilesX;
+        int tileY = id / tilesX;
+        for (int y = std::max(tileY - 1, 0); y <= std::min(tileY + 1, tilesY - 1); ++y)
+        {
+            for (int x = std::max(tileX - 1, 0); x <= std::min(tileX + 1, tilesX - 1); ++x)
+            {
+                int neighbour = y * tilesX + x;
+                if (!scheduled[neighbour])
+                {
+                    scheduled[neighbour] = 1;
+                    nextActive.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    // Returns whether the tile changed
+    template <class Rule>
+    bool stepTile(int id, Rule kernelRule)
+    {
+        int tileX = id % tilesX;
+        int tileY = id / tilesX;
+
+        // Rows -1 to 64 of the tile with the west and east neighbours shifted into every bit
+        Word rows[TILE + 2];
+        Word west[TILE + 2];
+        Word east[TILE + 2];
+        Word const* neighbours[3][3];
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                neighbours[dy + 1][dx + 1] = tileRows(tileX + dx, tileY + dy);
+            }
+        }
+        auto gather = [&](int index, int dy, int row)
+        {
+            Word const* const* tileRow = neighbours[dy + 1];
+            Word word = tileRow[1] ? tileRow[1][row] : 0;
+            rows[index] = word;
+            west[index] = word << 1 | (tileRow[0] ? tileRow[0][row] >> (TILE - 1) : 0);
+            east[index] = word >> 1 | (tileRow[2] ? tileRow[2][row] << (TILE - 1) : 0);
+        };
+        gather(0, -1, TILE - 1);
+        for (int row = 0; row < TILE; ++row)
+        {
+            gather(row + 1, 0, row);
+        }
+        gather(TILE + 1, 1, 0);
+
+        int validRows = std::min(TILE, height - tileY * TILE);
+        int validColumns = std::min(TILE, width - tileX * TILE);
+        Word mask = validColumns == TILE ? ~Word(0) : (Word(1) << validColumns) - 1;
+
+        Word* next = tiles[id].rows[parity ^ 1];
+        Word changed = 0;
+        for (int row = 0; row < validRows; ++row)
+        {
+            next[row] = mask & bitSliceNextGeneration(
+                                   west[row],
+                                   rows[row],
+                                   east[row],
+                                   west[row + 1],
+                                   rows[row + 1],
+                                   east[row + 1],
+                                   west[row + 2],
+                                   rows[row + 2],
+                                   east[row + 2],
+                                   kernelRule
+                               );
+            changed |= next[row] ^ rows[row + 1];
+        }
+        return changed != 0;
+    }
+};
+} // namespace
+
+std::unique_ptr<LifeEngine> createTiledEngine(int width, int height)
+{
+    return createTiledEngine(width, height, conwayRule);
+}
+
+std::unique_ptr<LifeEngine> createTiledEngine(int width, int height, LifeRule rule)
+{
+    return std::make_unique<TiledEngine>(width, height, rule);
+}
@@ -0,0 +1,294 @@
+#include "../simRecording.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Larger frames are rejected as corrupt headers rather than allocated
+#define MAX_FRAME_SIDE 16384
+
+typedef struct
+{
+    char const* path;
+    unsigned char const* data;
+    size_t size;
+    size_t offset;
+    uint32_t width;
+    uint32_t height;
+    uint32_t* frame;
+} Recording;
+
+typedef struct
+{
+    SimRecordingRun const* runs;
+    uint32_t runCount;
+} EncodedFrame;
+
+static int openRecording(Recording* recording, char const* path)
+{
+    recording->path = path;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror(path);
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+    {
+        perror(path);
+        close(fd);
+        return 0;
+    }
+
+    recording->size = st.st_size;
+    if (recording->size < sizeof(SimRecordingHeader))
+    {
+        fprintf(stderr, "%s: not a recording\n", path);
+        close(fd);
+        return 0;
+    }
+
+    void* data = mmap(NULL, recording->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror(path);
+        return 0;
+    }
+    madvise(data, recording->size, MADV_SEQUENTIAL);
+    recording->data = (unsigned char const*) data;
+
+    SimRecordingHeader header;
+    memcpy(&header, recording->data, sizeof(header));
+    if (memcmp(header.magic, SIM_RECORDING_MAGIC, sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "%s: not a recording\n", path);
+        munmap(data, recording->size);
+        return 0;
+    }
+    if (header.width == 0 || header.height == 0 || header.width > MAX_FRAME_SIDE ||
+        header.height > MAX_FRAME_SIDE)
+    {
+        fprintf(
+            stderr,
+            "%s: corrupt frame size %" PRIu32 "x%" PRIu32 "\n",
+            path,
+            header.width,
+            header.height
+        );
+        munmap(data, recording->size);
+        return 0;
+    }
+
+    recording->width = header.width;
+    recording->height = header.height;
+    recording->offset = sizeof(header);
+    recording->frame = (uint32_t*) calloc((size_t) header.width * header.height, sizeof(uint32_t));
+    if (!recording->frame)
+    {
+        perror(path);
+        munmap(data, recording->size);
+        return 0;
+    }
+    return 1;
+}
+
+// Returns 0 at the end of the recording, -1 if the recording is truncated or corrupt
+static int readFrame(Recording* recording, EncodedFrame* encoded)
+{
+    if (recording->offset == recording->size)
+    {
+        return 0;
+    }
+    if (recording->size - recording->offset < sizeof(uint32_t))
+    {
+        return -1;
+    }
+
+    memcpy(&encoded->runCount, recording->data + recording->offset, sizeof(uint32_t));
+    recording->offset += sizeof(uint32_t);
+    size_t runsSize = (size_t) encoded->runCount * sizeof(SimRecordingRun);
+    if (recording->size - recording->offset < runsSize)
+    {
+        return -1;
+    }
+
+    encoded->runs = (SimRecordingRun const*) (recording->data + recording->offset);
+    recording->offset += runsSize;
+
+    // The runs must cover the frame exactly, anything else would write outside of it
+    size_t frameSize = (size_t) recording->width * recording->height;
+    size_t covered = 0;
+    uint32_t* pixel = recording->frame;
+    for (uint32_t i = 0; i < encoded->runCount; ++i)
+    {
+        uint32_t value = encoded->runs[i].value;
+        uint32_t length = encoded->runs[i].length;
+        if (length > frameSize - covered)
+        {
+            return -1;
+        }
+        covered += length;
+        if (value != 0)
+        {
+            for (uint32_t j = 0; j < length; ++j)
+            {
+                pixel[j] ^= value;
+            }
+        }
+        pixel += length;
+    }
+    return covered == frameSize ? 1 : -1;
+}
+
+static uint64_t frameChecksum(Recording const* recording)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < (size_t) recording->width * recording->height; ++i)
+    {
+        hash ^= recording->frame[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static int replay(Recording* recording)
+{
+    EncodedFrame encoded;
+    long frames = 0;
+    int status;
+    while ((status = readFrame(recording, &encoded)) > 0)
+    {
+        ++frames;
+        printf(
+            "frame %ld runs %" PRIu32 " checksum %016" PRIx64 "\n",
+            frames,
+            encoded.runCount,
+            frameChecksum(recording)
+        );
+    }
+    if (status < 0)
+    {
+        fprintf(stderr, "%s: truncated or corrupt after frame %ld\n", recording->path, frames);
+    }
+    printf("%ld frames, %zu bytes\n", frames, recording->size);
+    return status < 0;
+}
+
+static int compare(Recording* first, Recording* second)
+{
+    if (first->width != second->width || first->height != second->height)
+    {
+        printf(
+            "frame sizes differ: %" PRIu32 "x%" PRIu32 " and %" PRIu32 "x%" PRIu32 "\n",
+            first->width,
+            first->height,
+            second->width,
+            second->height
+        );
+        return 1;
+    }
+
+    size_t frameSize = (size_t) first->width * first->height;
+    EncodedFrame firstEncoded;
+    EncodedFrame secondEncoded;
+    long frames = 0;
+    long differentFrames = 0;
+    int firstStatus;
+    int secondStatus;
+    while (1)
+    {
+        firstStatus = readFrame(first, &firstEncoded);
+        secondStatus = readFrame(second, &secondEncoded);
+        if (firstStatus <= 0 || secondStatus <= 0)
+        {
+            break;
+        }
+        ++frames;
+
+        // Encodings are canonical, so equal deltas on equal previous frames mean equal frames
+        if (differentFrames == 0 && firstEncoded.runCount == secondEncoded.runCount &&
+            memcmp(
+                firstEncoded.runs,
+                secondEncoded.runs,
+                firstEncoded.runCount * sizeof(SimRecordingRun)
+            ) == 0)
+        {
+            continue;
+        }
+        if (memcmp(first->frame, second->frame, frameSize * sizeof(uint32_t)) == 0)
+        {
+            continue;
+        }
+
+        size_t differentPixels = 0;
+        size_t firstDifference = frameSize;
+        for (size_t i = 0; i < frameSize; ++i)
+        {
+            if (first->frame[i] != second->frame[i])
+            {
+                firstDifference = differentPixels == 0 ? i : firstDifference;
+                ++differentPixels;
+            }
+        }
+        printf(
+            "frame %ld: %zu pixels differ, first at (%zu, %zu)\n",
+            frames,
+            differentPixels,
+            firstDifference % first->width,
+            firstDifference / first->width
+        );
+        ++differentFrames;
+    }
+
+    if (firstStatus < 0 || secondStatus < 0)
+    {
+        fprintf(stderr, "%s: truncated or corrupt\n", firstStatus < 0 ? first->path : second->path);
+        return 1;
+    }
+    if (firstStatus != secondStatus)
+    {
+        printf(
+            "%s ends after frame %ld\n",
+            firstStatus == 0 ? first->path : second->path,
+            frames
+        );
+        ++differentFrames;
+    }
+
+    printf("%ld frames compared, %ld differ\n", frames, differentFrames);
+    return differentFrames != 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2 && argc != 3)
+    {
+        fprintf(stderr, "Usage: simReplay <recording> [<other recording>]\n");
+        return 2;
+    }
+
+    Recording first;
+    if (!openRecording(&first, argv[1]))
+    {
+        return 2;
+    }
+    if (argc == 2)
+    {
+        return replay(&first);
+    }
+
+    Recording second;
+    if (!openRecording(&second, argv[2]))
+    {
+        return 2;
+    }
+    return compare(&first, &second);
+}
@@ -1,72 +1,349 @@
+#include "lifeStep.h"
+#include "pattern.h"
+#include "rule.h"
 #include "sim.h"
 
-#define ZOOM 8
-#define ZOOMED_Y_SIZE (SIM_Y_SIZE / ZOOM + (SIM_Y_SIZE % ZOOM != 0))
-#define ZOOMED_X_SIZE (SIM_X_SIZE / ZOOM + (SIM_X_SIZE % ZOOM != 0))
-#define CENTER_Y (ZOOMED_Y_SIZE / 2)
-#define CENTER_X (ZOOMED_X_SIZE / 2)
+#include <stdint.h>
+#include <string.h>
 
-void app()
+#define ZOOM SIM_ZOOM
+#define VIEWPORT_Y_SIZE (SIM_Y_SIZE / ZOOM + (SIM_Y_SIZE % ZOOM != 0))
+#define VIEWPORT_X_SIZE (SIM_X_SIZE / ZOOM + (SIM_X_SIZE % ZOOM != 0))
+
+// Cells are stored with a one-cell ghost border, so every cell has eight neighbours in memory.
+// Ghost cells stay dead, or mirror the opposite edge when built with TOROIDAL.
+// The grid size is chosen at startup and only the part under the viewport is drawn.
+static int Width;
+static int Height;
+static size_t Stride;
+static unsigned char* CurrentlyAlive;
+static unsigned char* NextAlive;
+// Next state of a cell at its own state * 9 plus its live neighbour count
+static unsigned char NextState[2 * 9];
+
+// Longest period looked for, the hashes of this many previous generations are kept
+#define MAX_PERIOD 64
+#define HISTORY_SIZE (MAX_PERIOD + 1)
+// Longer cycles are reported but keep being stepped
+#define CYCLE_CACHE_SIZE (256UL << 20)
+
+// Hash of the cells, taken a word at a time from each row once it is stepped, while the row is
+// still in cache, so the loop over the cells stays free of it. Once the hash of a generation
+// repeats one of the last MAX_PERIOD ones, the grids of the next period are copied aside and
+// the cycle is confirmed cell by cell, after which appStep replays the copies instead of
+// stepping. Still lifes need no copies, the grid simply stays as it is.
+static uint64_t Hash;
+static int Hashed;
+static long long Generation;
+static uint64_t History[HISTORY_SIZE];
+// Period being recorded and how many of its grids are copied so far
+static int Candidate;
+static int Recorded;
+// Confirmed period and the position in it, 0 while the grid is still stepped
+static int Period;
+static int Phase;
+// Reported as the period metric, also set for cycles too long to replay
+static int DetectedPeriod;
+static unsigned char* Cycle[MAX_PERIOD];
+static int CycleAllocated;
+
+// Viewport cells that changed since the last frame, as offsets into the viewport, so a frame
+// only redraws those. They are found by comparing the viewport cells of the two grids after
+// every generation, which keeps the step loop free of them. Everything is redrawn after the
+// viewport moved or when more cells changed than the list holds
+#define DIRTY_CAPACITY (VIEWPORT_X_SIZE * VIEWPORT_Y_SIZE)
+static int Dirty[DIRTY_CAPACITY];
+static int DirtyCount;
+static int FullRedraw = 1;
+static int RenderedX;
+static int RenderedY;
+
+void appInit()
 {
-    int currently_alive[ZOOMED_Y_SIZE][ZOOMED_X_SIZE] = {0};
-    int next_alive[ZOOMED_Y_SIZE][ZOOMED_X_SIZE] = {0};
+    simGridSize(&Width, &Height);
+    Stride = (size_t) Width + 2;
+    size_t cells = Stride * (Height + 2);
+    CurrentlyAlive = simAlloc(cells);
+    NextAlive = simAlloc(cells);
+
+    Rule rule = ruleFromEnvironment();
+    for (int n = 0; n <= 8; ++n)
+    {
+        NextState[n] = rule.birth >> n & 1;
+        NextState[9 + n] = rule.survival >> n & 1;
+    }
+
+    // SIM_RESTORE replaces the whole starting state
+    if (simCheckpointGrid(&CurrentlyAlive, cells))
+    {
+        return;
+    }
 
-    currently_alive[CENTER_Y - 1][CENTER_X] = 1;
-    currently_alive[CENTER_Y - 1][CENTER_X + 1] = 1;
-    currently_alive[CENTER_Y][CENTER_X - 1] = 1;
-    currently_alive[CENTER_Y][CENTER_X] = 1;
-    currently_alive[CENTER_Y + 1][CENTER_X] = 1;
+    int width = Width;
+    int height = Height;
+    size_t stride = Stride;
+    unsigned char* currently_alive = CurrentlyAlive;
 
-#ifdef ITERATION_LIMIT
-    for (int i = 0; i < ITERATION_LIMIT; ++i)
+    // LIFE_PATTERN replaces the built-in starting state
+    if (!patternLoadFromEnvironment(currently_alive + stride + 1, stride, width, height))
+    {
+#ifdef SOUP_DENSITY
+        // Random soup where SOUP_DENSITY percent of cells are alive
+        int* soup = simAlloc(width * sizeof(int));
+        for (int y = 1; y <= height; ++y)
+        {
+            simRandFill(soup, width);
+            for (int x = 1; x <= width; ++x)
+            {
+                currently_alive[y * stride + x] = soup[x - 1] % 100 < SOUP_DENSITY;
+            }
+        }
 #else
-    while (1)
+        size_t center = height / 2 * stride + width / 2;
+        currently_alive[center + 1] = 1;
+        currently_alive[center + 2] = 1;
+        currently_alive[center + stride] = 1;
+        currently_alive[center + stride + 1] = 1;
+        currently_alive[center + 2 * stride + 1] = 1;
 #endif
+    }
+}
+
+static uint64_t mixWord(uint64_t hash, uint64_t word)
+{
+    hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 29);
+}
+
+// Adds the cells of a row without its ghost cells to the hash. Four words are mixed
+// independently, so the multiplies do not wait for each other
+static uint64_t hashRow(uint64_t hash, unsigned char const* cells)
+{
+    uint64_t lanes[4] = {hash, hash + 1, hash + 2, hash + 3};
+    int x = 0;
+    for (; x + 4 * 8 <= Width; x += 4 * 8)
+    {
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            uint64_t word;
+            memcpy(&word, cells + x + lane * 8, sizeof(word));
+            lanes[lane] = mixWord(lanes[lane], word);
+        }
+    }
+    for (; x < Width; x += 8)
+    {
+        uint64_t word = 0;
+        memcpy(&word, cells + x, Width - x < 8 ? Width - x : 8);
+        lanes[0] = mixWord(lanes[0], word);
+    }
+    return mixWord(mixWord(mixWord(lanes[0], lanes[1]), lanes[2]), lanes[3]);
+}
+
+static void hashGrid()
+{
+    Hash = 0;
+    for (int y = 1; y <= Height; ++y)
+    {
+        Hash = hashRow(Hash, CurrentlyAlive + y * Stride + 1);
+    }
+    Generation = 0;
+    History[0] = Hash;
+    Hashed = 1;
+}
+
+// Ghost cells are only refreshed right before a step, so they are left out
+static int sameCells(unsigned char const* a, unsigned char const* b)
+{
+    for (int y = 1; y <= Height; ++y)
+    {
+        if (memcmp(a + y * Stride + 1, b + y * Stride + 1, Width) != 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Called after every stepped generation with its grid and the grid of the generation before
+static void findCycle(unsigned char* current, unsigned char const* previous)
+{
+    size_t cells = Stride * (Height + 2);
+    ++Generation;
+    History[Generation % HISTORY_SIZE] = Hash;
+
+    if (Candidate)
+    {
+        if (++Recorded < Candidate)
+        {
+            memcpy(Cycle[Recorded], current, cells);
+            return;
+        }
+        // A mismatch is a hash collision, the search simply goes on
+        if (sameCells(current, Cycle[0]))
+        {
+            Period = Candidate;
+            DetectedPeriod = Period;
+            Phase = 0;
+        }
+        Candidate = 0;
+        return;
+    }
+
+    for (int period = 1; period <= MAX_PERIOD && period <= Generation; ++period)
     {
-        for (int y = 0; y < ZOOMED_Y_SIZE; ++y)
+        if (History[(Generation - period) % HISTORY_SIZE] != Hash)
+        {
+            continue;
+        }
+        if (period == 1)
+        {
+            Period = sameCells(current, previous);
+            DetectedPeriod = Period;
+        }
+        else if (period * cells <= CYCLE_CACHE_SIZE)
         {
-            for (int x = 0; x < ZOOMED_X_SIZE; ++x)
+            for (; CycleAllocated < period; ++CycleAllocated)
             {
-                int alive_neighbors = 0;
-                alive_neighbors += (x > 0) && (y > 0) && (currently_alive[y - 1][x - 1]);
-                alive_neighbors += (y > 0) && (currently_alive[y - 1][x]);
-                alive_neighbors +=
-                    (x < ZOOMED_X_SIZE - 1) && (y > 0) && (currently_alive[y - 1][x + 1]);
-                alive_neighbors += (x < ZOOMED_X_SIZE - 1) && (currently_alive[y][x + 1]);
-                alive_neighbors += (x < ZOOMED_X_SIZE - 1) && (y < ZOOMED_Y_SIZE - 1) &&
-                                   (currently_alive[y + 1][x + 1]);
-                alive_neighbors += (y < ZOOMED_Y_SIZE - 1) && (currently_alive[y + 1][x]);
-                alive_neighbors +=
-                    (x > 0) && (y < ZOOMED_Y_SIZE - 1) && (currently_alive[y + 1][x - 1]);
-                alive_neighbors += (x > 0) && (currently_alive[y][x - 1]);
-
-                if (currently_alive[y][x])
-                {
-                    next_alive[y][x] = alive_neighbors >= 2 && alive_neighbors <= 3;
-                }
-                else
-                {
-                    next_alive[y][x] = alive_neighbors == 3;
-                }
+                Cycle[CycleAllocated] = simAlloc(cells);
             }
+            memcpy(Cycle[0], current, cells);
+            Candidate = period;
+            Recorded = 0;
         }
+        else
+        {
+            DetectedPeriod = period;
+        }
+        return;
+    }
+}
 
-        for (int y = 0; y < SIM_Y_SIZE; ++y)
+// Adds the viewport cells that differ between two grids to the dirty list, 0 when it is full
+static int markChangedCells(
+    unsigned char const* before,
+    unsigned char const* after,
+    int* dirty_count
+)
+{
+    for (int view_y = 0; view_y < VIEWPORT_Y_SIZE && RenderedY + view_y < Height; ++view_y)
+    {
+        size_t row = (RenderedY + view_y + 1) * Stride + RenderedX + 1;
+        for (int view_x = 0; view_x < VIEWPORT_X_SIZE && RenderedX + view_x < Width; ++view_x)
         {
-            for (int x = 0; x < SIM_X_SIZE; ++x)
+            if (before[row + view_x] == after[row + view_x])
             {
-                int color = currently_alive[y / ZOOM][x / ZOOM] ? 0xFFFFFFFF : 0xFF000000;
-                simPutPixel(x, y, color);
+                continue;
             }
+            if (*dirty_count == DIRTY_CAPACITY)
+            {
+                return 0;
+            }
+            Dirty[(*dirty_count)++] = view_y * VIEWPORT_X_SIZE + view_x;
         }
-        simFlush();
+    }
+    return 1;
+}
+
+void appStep(int generations)
+{
+    int width = Width;
+    int height = Height;
+    size_t stride = Stride;
+    unsigned char* currently_alive = CurrentlyAlive;
+    unsigned char* next_alive = NextAlive;
+    int stepped = 0;
+    int dirty_count = DirtyCount;
+    int full_redraw = FullRedraw;
+
+    if (!Hashed)
+    {
+        hashGrid();
+    }
 
-        for (int y = 0; y < ZOOMED_Y_SIZE; ++y)
+    for (int i = 0; i < generations; ++i)
+    {
+        if (Period)
         {
-            for (int x = 0; x < ZOOMED_X_SIZE; ++x)
+            Phase = (Phase + 1) % Period;
+            if (Period > 1)
             {
-                currently_alive[y][x] = next_alive[y][x];
+                unsigned char const* previous = currently_alive;
+                currently_alive = Cycle[Phase];
+                full_redraw = full_redraw ||
+                              !markChangedCells(previous, currently_alive, &dirty_count);
             }
+            continue;
+        }
+
+#ifdef TOROIDAL
+        for (int y = 1; y <= height; ++y)
+        {
+            currently_alive[y * stride] = currently_alive[y * stride + width];
+            currently_alive[y * stride + width + 1] = currently_alive[y * stride + 1];
+        }
+        memcpy(currently_alive, currently_alive + height * stride, stride);
+        memcpy(currently_alive + (height + 1) * stride, currently_alive + stride, stride);
+#endif
+
+        uint64_t hash = 0;
+        for (int y = 1; y <= height; ++y)
+        {
+            unsigned char* next_row = next_alive + y * stride;
+            lifeStepRow(currently_alive + y * stride, stride, width, NextState, next_row);
+            hash = hashRow(hash, next_row + 1);
+        }
+        Hash = hash;
+        ++stepped;
+
+        unsigned char* previous = currently_alive;
+        currently_alive = next_alive;
+        next_alive = previous;
+        full_redraw = full_redraw || !markChangedCells(previous, currently_alive, &dirty_count);
+        findCycle(currently_alive, previous);
+    }
+
+    CurrentlyAlive = currently_alive;
+    NextAlive = next_alive;
+    DirtyCount = dirty_count;
+    FullRedraw = full_redraw;
+    simMetric("period", DetectedPeriod);
+    simMetric("stepped_generations", stepped);
+}
+
+void appRender(int viewport_x, int viewport_y)
+{
+    int width = Width;
+    int height = Height;
+    size_t stride = Stride;
+    unsigned char const* currently_alive = CurrentlyAlive;
+
+    if (!FullRedraw && viewport_x == RenderedX && viewport_y == RenderedY)
+    {
+        for (int i = 0; i < DirtyCount; ++i)
+        {
+            int x = Dirty[i] % VIEWPORT_X_SIZE;
+            int y = Dirty[i] / VIEWPORT_X_SIZE;
+            int alive = currently_alive[(viewport_y + y + 1) * stride + viewport_x + x + 1];
+            simPutPixel(x, y, alive ? 0xFFFFFFFF : 0xFF000000);
+        }
+        DirtyCount = 0;
+        return;
+    }
+
+    for (int y = 0; y < VIEWPORT_Y_SIZE; ++y)
+    {
+        // Parts of the viewport past a grid smaller than the window stay black
+        int grid_y = viewport_y + y;
+        unsigned char const* row = currently_alive + (grid_y < height ? grid_y + 1 : 0) * stride;
+        for (int x = 0; x < VIEWPORT_X_SIZE; ++x)
+        {
+            int grid_x = viewport_x + x;
+            int alive = grid_y < height && grid_x < width && row[grid_x + 1];
+            simPutPixel(x, y, alive ? 0xFFFFFFFF : 0xFF000000);
         }
     }
+    RenderedX = viewport_x;
+    RenderedY = viewport_y;
+    FullRedraw = 0;
+    DirtyCount = 0;
 }
@@ -0,0 +1,41 @@
+#include "lifeStep.h"
+
+void lifeStepRow(
+    unsigned char const* row,
+    size_t stride,
+    int width,
+    unsigned char const* next_state,
+    unsigned char* next_row
+)
+{
+    unsigned char const* above = row - stride;
+    unsigned char const* below = row + stride;
+    for (int x = 1; x <= width; ++x)
+    {
+        int alive_neighbors = above[x - 1] + above[x] + above[x + 1] + row[x + 1] +
+                              below[x + 1] + below[x] + below[x - 1] + row[x - 1];
+
+        next_row[x] = next_state[row[x] * 9 + alive_neighbors];
+    }
+}
+
+void lifeStep(
+    unsigned char const* currently_alive,
+    unsigned char* next_alive,
+    size_t stride,
+    int width,
+    int height,
+    unsigned char const* next_state
+)
+{
+    for (int y = 1; y <= height; ++y)
+    {
+        lifeStepRow(
+            currently_alive + y * stride,
+            stride,
+            width,
+            next_state,
+            next_alive + y * stride
+        );
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef LIFE_STEP_H
+#define LIFE_STEP_H
+
+#include <stddef.h>
+
+// The step of app.c, shared with the Life engines and the JIT benchmark so they all time the
+// same code. Grids hold one byte per cell with a one-cell ghost border, rows are stride bytes
+// apart, and next_state[state * 9 + count] is the next state of a cell with count live
+// neighbours. Ghost cells are read as they are and never written.
+
+// Steps the width cells after the ghost cell at row into next_row
+void lifeStepRow(
+    unsigned char const* row,
+    size_t stride,
+    int width,
+    unsigned char const* next_state,
+    unsigned char* next_row
+);
+
+// Steps all height rows of the grid
+void lifeStep(
+    unsigned char const* currently_alive,
+    unsigned char* next_alive,
+    size_t stride,
+    int width,
+    int height,
+    unsigned char const* next_state
+);
+
+#endif
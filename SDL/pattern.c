@@ -0,0 +1,302 @@
+#include "pattern.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Counts, sizes and positions from the file saturate at the largest grid size, so that
+// malformed files cannot overflow them and every cell past the limit is outside the grid anyway
+#define NUMBER_LIMIT ((long) INT_MAX)
+
+typedef struct
+{
+    unsigned char* cells;
+    size_t stride;
+    int width;
+    int height;
+} Grid;
+
+static int isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static int isDigit(char c)
+{
+    return '0' <= c && c <= '9';
+}
+
+static char const* skipSpaces(char const* cursor, char const* end)
+{
+    while (cursor < end && isSpace(*cursor))
+    {
+        ++cursor;
+    }
+    return cursor;
+}
+
+static char const* skipLine(char const* cursor, char const* end)
+{
+    char const* newline = (char const*) memchr(cursor, '\n', end - cursor);
+    return newline ? newline + 1 : end;
+}
+
+static long appendDigit(long value, char digit)
+{
+    long next = value * 10 + (digit - '0');
+    return value > NUMBER_LIMIT / 10 || next > NUMBER_LIMIT ? NUMBER_LIMIT : next;
+}
+
+// The mapping is not null-terminated, so numbers are parsed by hand
+static long parseNumber(char const** cursor, char const* end)
+{
+    long value = 0;
+    for (; *cursor < end && isDigit(**cursor); ++*cursor)
+    {
+        value = appendDigit(value, **cursor);
+    }
+    return value;
+}
+
+// Positions start within the limit and runs are at most the limit, so the sum cannot overflow
+static long advance(long position, long run)
+{
+    return position + run > NUMBER_LIMIT ? NUMBER_LIMIT : position + run;
+}
+
+static long clampPosition(long position)
+{
+    if (position == PATTERN_CENTER || (-NUMBER_LIMIT <= position && position <= NUMBER_LIMIT))
+    {
+        return position;
+    }
+    return position < 0 ? -NUMBER_LIMIT : NUMBER_LIMIT;
+}
+
+static void setRun(Grid const* grid, long x, long y, long length)
+{
+    if (y < 0 || y >= grid->height)
+    {
+        return;
+    }
+    long from = x < 0 ? 0 : x;
+    long to = x + length > grid->width ? grid->width : x + length;
+    if (from < to)
+    {
+        memset(grid->cells + y * grid->stride + from, 1, to - from);
+    }
+}
+
+static long placement(long requested, int gridSize, long patternSize)
+{
+    return requested == PATTERN_CENTER ? (gridSize - patternSize) / 2 : requested;
+}
+
+// Reads "x = <width>, y = <height>" and leaves the cursor after the header line
+static char const* parseRleHeader(char const* cursor, char const* end, long* width, long* height)
+{
+    char const* lineEnd = skipLine(cursor, end);
+    while (cursor < lineEnd)
+    {
+        char name = *cursor++;
+        if (name != 'x' && name != 'y')
+        {
+            continue;
+        }
+        cursor = skipSpaces(cursor, lineEnd);
+        if (cursor < lineEnd && *cursor == '=')
+        {
+            cursor = skipSpaces(cursor + 1, lineEnd);
+            *(name == 'x' ? width : height) = parseNumber(&cursor, lineEnd);
+        }
+    }
+    return lineEnd;
+}
+
+// <count><tag> runs where b or . is dead, any other letter is alive, $ ends a row and ! the pattern
+static void parseRle(char const* cursor, char const* end, Grid const* grid, long left, long top)
+{
+    long width = 0;
+    long height = 0;
+    while (cursor < end && (*cursor == '#' || isSpace(*cursor)))
+    {
+        cursor = *cursor == '#' ? skipLine(cursor, end) : cursor + 1;
+    }
+    if (cursor < end && *cursor == 'x')
+    {
+        cursor = parseRleHeader(cursor, end, &width, &height);
+    }
+
+    long x = placement(left, grid->width, width);
+    long y = placement(top, grid->height, height);
+    long rowStart = x;
+    long count = 0;
+    for (; cursor < end; ++cursor)
+    {
+        char c = *cursor;
+        if (isDigit(c))
+        {
+            count = appendDigit(count, c);
+            continue;
+        }
+        if (isSpace(c))
+        {
+            continue;
+        }
+
+        long run = count ? count : 1;
+        count = 0;
+        if (c == '!')
+        {
+            return;
+        }
+        else if (c == '$')
+        {
+            y = advance(y, run);
+            x = rowStart;
+        }
+        else if (c == 'b' || c == '.')
+        {
+            x = advance(x, run);
+        }
+        else if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z'))
+        {
+            setRun(grid, x, y, run);
+            x = advance(x, run);
+        }
+    }
+}
+
+// Rows of . for dead and O or * for alive cells, lines starting with ! are comments.
+// Centering needs the size up front, which costs a scan over the line ends
+static void parsePlaintext(char const* cursor, char const* end, Grid const* grid, long x, long y)
+{
+    if (x == PATTERN_CENTER || y == PATTERN_CENTER)
+    {
+        long width = 0;
+        long height = 0;
+        for (char const* line = cursor; line < end; line = skipLine(line, end))
+        {
+            if (*line != '!')
+            {
+                char const* newline = (char const*) memchr(line, '\n', end - line);
+                long length = (newline ? newline : end) - line;
+                width = length > width ? length : width;
+                ++height;
+            }
+        }
+        x = placement(x, grid->width, width);
+        y = placement(y, grid->height, height);
+    }
+
+    for (; cursor < end; cursor = skipLine(cursor, end))
+    {
+        if (*cursor == '!')
+        {
+            continue;
+        }
+        for (char const* cell = cursor; cell < end && *cell != '\n'; ++cell)
+        {
+            if (*cell == 'O' || *cell == '*')
+            {
+                setRun(grid, x + (cell - cursor), y, 1);
+            }
+        }
+        ++y;
+    }
+}
+
+int patternLoad(
+    char const* path,
+    unsigned char* cells,
+    size_t stride,
+    int width,
+    int height,
+    long x,
+    long y
+)
+{
+    int file = open(path, O_RDONLY);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) != 0)
+    {
+        perror(path);
+        if (file >= 0)
+        {
+            close(file);
+        }
+        return -1;
+    }
+    if (status.st_size == 0)
+    {
+        fprintf(stderr, "[pattern] %s is empty\n", path);
+        close(file);
+        return -1;
+    }
+
+    size_t size = status.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED)
+    {
+        perror(path);
+        return -1;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    Grid grid = {cells, stride, width, height};
+    x = clampPosition(x);
+    y = clampPosition(y);
+    char const* begin = (char const*) mapping;
+    char const* cursor = skipSpaces(begin, begin + size);
+    if (cursor < begin + size && (*cursor == '!' || *cursor == '.' || *cursor == 'O'))
+    {
+        parsePlaintext(cursor, begin + size, &grid, x, y);
+    }
+    else
+    {
+        parseRle(cursor, begin + size, &grid, x, y);
+    }
+
+    munmap(mapping, size);
+    return 0;
+}
+
+int patternLoadFromEnvironment(unsigned char* cells, size_t stride, int width, int height)
+{
+    char const* path = getenv("LIFE_PATTERN");
+    if (!path)
+    {
+        return 0;
+    }
+
+    long x = PATTERN_CENTER;
+    long y = PATTERN_CENTER;
+    char const* at = getenv("LIFE_PATTERN_AT");
+    if (at && sscanf(at, "%ld,%ld", &x, &y) != 2)
+    {
+        fprintf(stderr, "[pattern] Unknown LIFE_PATTERN_AT '%s', expected <x>,<y>\n", at);
+        exit(EXIT_FAILURE);
+    }
+
+    struct timespec start, finish;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (patternLoad(path, cells, stride, width, height, x, y) != 0)
+    {
+        exit(EXIT_FAILURE);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    fprintf(
+        stderr,
+        "[pattern] Loaded %s in %.3f ms\n",
+        path,
+        (finish.tv_sec - start.tv_sec) * 1e3 + (finish.tv_nsec - start.tv_nsec) * 1e-6
+    );
+    return 1;
+}
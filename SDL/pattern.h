@@ -0,0 +1,31 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <limits.h>
+#include <stddef.h>
+
+// Loader for Life patterns in the RLE and plaintext (.cells) formats.
+// The file is memory-mapped and parsed in place, so loading allocates nothing.
+
+// Centers the pattern along an axis when passed as its coordinate
+#define PATTERN_CENTER LONG_MIN
+
+// Sets the live cells of the pattern at path to 1 in a byte-per-cell grid of width x height
+// cells whose rows are stride bytes apart, leaving the other cells untouched.
+// The top-left corner of the pattern goes to (x, y) and cells outside the grid are dropped.
+// Returns 0 on success and -1 after reporting an error to stderr
+int patternLoad(
+    char const* path,
+    unsigned char* cells,
+    size_t stride,
+    int width,
+    int height,
+    long x,
+    long y
+);
+
+// Loads the pattern named by LIFE_PATTERN at LIFE_PATTERN_AT=<x>,<y> (centered when unset).
+// Returns 1 if a pattern was loaded and 0 if LIFE_PATTERN is unset, exits if loading fails
+int patternLoadFromEnvironment(unsigned char* cells, size_t stride, int width, int height);
+
+#endif
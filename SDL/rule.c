@@ -0,0 +1,72 @@
+#include "rule.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+NamedRule const NamedRules[] = {
+    {"conway", "B3/S23"},
+    {"highlife", "B36/S23"},
+    {"daynight", "B3678/S34678"},
+    {"seeds", "B2/S"},
+    {NULL, NULL},
+};
+
+int ruleParse(char const* name, Rule* rule)
+{
+    for (NamedRule const* named = NamedRules; named->name; ++named)
+    {
+        if (strcmp(name, named->name) == 0)
+        {
+            name = named->rulestring;
+        }
+    }
+
+    Rule parsed = {0, 0};
+    unsigned* counts = NULL;
+    int seenBirth = 0;
+    int seenSurvival = 0;
+    for (char const* c = name; *c; ++c)
+    {
+        if ((*c == 'B' || *c == 'b') && !seenBirth && !counts)
+        {
+            counts = &parsed.birth;
+            seenBirth = 1;
+        }
+        else if ((*c == 'S' || *c == 's') && !seenSurvival && !counts)
+        {
+            counts = &parsed.survival;
+            seenSurvival = 1;
+        }
+        else if (*c == '/' && counts)
+        {
+            counts = NULL;
+        }
+        else if ('0' <= *c && *c <= '8' && counts)
+        {
+            *counts |= 1u << (*c - '0');
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    if (!seenBirth || !seenSurvival || parsed.birth & 1)
+    {
+        return -1;
+    }
+    *rule = parsed;
+    return 0;
+}
+
+Rule ruleFromEnvironment()
+{
+    char const* name = getenv("LIFE_RULE");
+    Rule rule;
+    if (ruleParse(name ? name : "conway", &rule) != 0)
+    {
+        fprintf(stderr, "[rule] Unknown LIFE_RULE '%s', expected a name or B<n>/S<n>\n", name);
+        exit(EXIT_FAILURE);
+    }
+    return rule;
+}
@@ -0,0 +1,29 @@
+#ifndef RULE_H
+#define RULE_H
+
+// Outer-totalistic Life rule: bit n of birth is set when a dead cell with n live neighbours
+// is born, bit n of survival when a live cell with n live neighbours stays alive
+typedef struct
+{
+    unsigned birth;
+    unsigned survival;
+} Rule;
+
+typedef struct
+{
+    char const* name;
+    char const* rulestring;
+} NamedRule;
+
+// Rules known by name, the last entry has a null name
+extern NamedRule const NamedRules[];
+
+// Parses conway, highlife, daynight, seeds or a B/S rulestring such as B36/S23.
+// Returns 0 on success and -1 for malformed rules and for rules with B0,
+// which would turn the dead cells outside the grid alive
+int ruleParse(char const* name, Rule* rule);
+
+// Reads LIFE_RULE (conway by default), exits if the rule is malformed
+Rule ruleFromEnvironment();
+
+#endif
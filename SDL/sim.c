@@ -1,29 +1,183 @@
-#include "sim.h"
+#include "simCommon.h"
 
 #include <SDL2/SDL.h>
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
 
-#define FRAME_TICKS 50
+#define DEFAULT_FPS 20
+
+// Frame pacing policy, chosen at simInit from SIM_PACING:
+//   <N>       present at most N frames per second (default is 20)
+//   vsync     present in sync with the display refresh
+//   uncapped  present as fast as possible and report frames/sec at simExit
+typedef enum
+{
+    PACING_FIXED_FPS,
+    PACING_VSYNC,
+    PACING_UNCAPPED,
+} Pacing;
 
 static SDL_Renderer* Renderer = NULL;
 static SDL_Window* Window = NULL;
-static Uint32 Ticks = 0;
+static SDL_Texture* Texture = NULL;
+
+static Pacing FramePacing = PACING_FIXED_FPS;
+static Uint64 FramePeriod = 0;
+static Uint64 LastPresent = 0;
+static Uint64 StartTime = 0;
+static long Frames = 0;
+
+static void readPacing()
+{
+    char const* pacing = getenv("SIM_PACING");
+    int fps = DEFAULT_FPS;
+
+    if (pacing && strcmp(pacing, "vsync") == 0)
+    {
+        FramePacing = PACING_VSYNC;
+    }
+    else if (pacing && strcmp(pacing, "uncapped") == 0)
+    {
+        FramePacing = PACING_UNCAPPED;
+    }
+    else if (pacing && (fps = atoi(pacing)) <= 0)
+    {
+        fprintf(stderr, "[sim] Unknown SIM_PACING '%s', using %d FPS\n", pacing, DEFAULT_FPS);
+        fps = DEFAULT_FPS;
+    }
+
+    FramePeriod = SDL_GetPerformanceFrequency() / fps;
+}
+
+// Arrow keys move the viewport by a cell per frame, or by a whole screen while shift is held
+static void panViewport()
+{
+    Uint8 const* keys = SDL_GetKeyboardState(NULL);
+    int page = keys[SDL_SCANCODE_LSHIFT] || keys[SDL_SCANCODE_RSHIFT];
+    int dx = keys[SDL_SCANCODE_RIGHT] - keys[SDL_SCANCODE_LEFT];
+    int dy = keys[SDL_SCANCODE_DOWN] - keys[SDL_SCANCODE_UP];
+    if (dx || dy)
+    {
+        simMoveViewport(
+            page ? dx * FramebufferWidth : dx,
+            page ? dy * FramebufferHeight : dy
+        );
+    }
+}
+
+static void waitForNextFrame()
+{
+    if (FramePacing != PACING_FIXED_FPS)
+    {
+        return;
+    }
+
+    Uint64 elapsed = SDL_GetPerformanceCounter() - LastPresent;
+    if (elapsed < FramePeriod)
+    {
+        uint64_t sleepStart = simNow();
+        SDL_Delay((FramePeriod - elapsed) * 1000 / SDL_GetPerformanceFrequency());
+        simStatsRecord(SIM_TIMER_SLEEP, simNow() - sleepStart);
+    }
+}
+
+// SDL only supports rendering on the thread that created the window, so the frame is uploaded
+// and presented right here. Framebuffer is copied into the streaming texture rather than
+// handed over, so it keeps its contents between frames
+static void submitFrame()
+{
+    waitForNextFrame();
+    LastPresent = SDL_GetPerformanceCounter();
+
+    uint64_t uploadStart = simNow();
+    void* pixels;
+    int pitch;
+    if (SDL_LockTexture(Texture, NULL, &pixels, &pitch) == 0)
+    {
+        for (int y = 0; y < FramebufferHeight; ++y)
+        {
+            memcpy(
+                (char*) pixels + y * pitch,
+                Framebuffer + y * FramebufferWidth,
+                FramebufferWidth * sizeof(Uint32)
+            );
+        }
+        SDL_UnlockTexture(Texture);
+    }
+    simStatsRecord(SIM_TIMER_UPLOAD, simNow() - uploadStart);
+
+    uint64_t presentStart = simNow();
+    SDL_RenderCopy(Renderer, Texture, NULL, NULL);
+    SDL_RenderPresent(Renderer);
+    simStatsRecord(SIM_TIMER_PRESENT, simNow() - presentStart);
+    ++Frames;
+}
 
 void simInit()
 {
+    simInitLogical(SIM_X_SIZE, SIM_Y_SIZE);
+}
+
+void simInitLogical(int w, int h)
+{
+    simCommonInit(w, h);
     SDL_Init(SDL_INIT_VIDEO);
-    SDL_CreateWindowAndRenderer(SIM_X_SIZE, SIM_Y_SIZE, 0, &Window, &Renderer);
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    readPacing();
+
+    Window = SDL_CreateWindow(
+        "",
+        SDL_WINDOWPOS_UNDEFINED,
+        SDL_WINDOWPOS_UNDEFINED,
+        SIM_X_SIZE,
+        SIM_Y_SIZE,
+        0
+    );
+
+    Renderer = SDL_CreateRenderer(
+        Window,
+        -1,
+        FramePacing == PACING_VSYNC ? SDL_RENDERER_PRESENTVSYNC : 0
+    );
+    SDL_RenderSetLogicalSize(Renderer, FramebufferWidth, FramebufferHeight);
+    Texture = SDL_CreateTexture(
+        Renderer,
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_STREAMING,
+        FramebufferWidth,
+        FramebufferHeight
+    );
+    SDL_SetTextureBlendMode(Texture, SDL_BLENDMODE_NONE);
     SDL_SetRenderDrawColor(Renderer, 0, 0, 0, 0);
     SDL_RenderClear(Renderer);
-    srand(time(NULL));
+
     simPutPixel(0, 0, 0);
-    simFlush();
+    submitFrame();
+
+    Frames = 0;
+    StartTime = SDL_GetPerformanceCounter();
+    simStatsInit();
 }
 
 void simExit()
 {
+    if (FramePacing == PACING_UNCAPPED)
+    {
+        double seconds =
+            (double) (SDL_GetPerformanceCounter() - StartTime) / SDL_GetPerformanceFrequency();
+        fprintf(
+            stderr,
+            "[sim] %ld frames in %.3f s (%.1f frames/s)\n",
+            Frames,
+            seconds,
+            seconds > 0 ? Frames / seconds : 0.0
+        );
+    }
+
+    simCommonExit();
+    SDL_DestroyTexture(Texture);
     SDL_DestroyRenderer(Renderer);
     SDL_DestroyWindow(Window);
     SDL_Quit();
@@ -33,28 +187,8 @@ void simFlush()
 {
     SDL_PumpEvents();
     assert(SDL_TRUE != SDL_HasEvent(SDL_QUIT) && "User-requested quit");
-    Uint32 cur_ticks = SDL_GetTicks() - Ticks;
-    if (cur_ticks < FRAME_TICKS)
-    {
-        SDL_Delay(FRAME_TICKS - cur_ticks);
-    }
-    SDL_RenderPresent(Renderer);
-}
-
-void simPutPixel(int x, int y, int argb)
-{
-    assert(0 <= x && x < SIM_X_SIZE && "Out of range");
-    assert(0 <= y && y < SIM_Y_SIZE && "Out of range");
-    Uint8 a = argb >> 24;
-    Uint8 r = (argb >> 16) & 0xFF;
-    Uint8 g = (argb >> 8) & 0xFF;
-    Uint8 b = argb & 0xFF;
-    SDL_SetRenderDrawColor(Renderer, r, g, b, a);
-    SDL_RenderDrawPoint(Renderer, x, y);
-    Ticks = SDL_GetTicks();
-}
-
-int simRand()
-{
-    return rand();
+    panViewport();
+    simCommonFlush();
+    submitFrame();
+    simCommonFlushEnd();
 }
@@ -1,12 +1,51 @@
 #define SIM_X_SIZE 512
 #define SIM_Y_SIZE 256
+// Window pixels per app cell, used by the drivers to size the logical framebuffer
+#define SIM_ZOOM 8
+// Largest grid side accepted through SIM_GRID
+#define SIM_MAX_GRID_SIZE 100000
+
+#include <stddef.h>
 
 #ifndef __sim__
 void simFlush();
 void simPutPixel(int x, int y, int argb);
+void simFillRect(int x, int y, int w, int h, int argb);
+void simPutSpan(int x, int y, int len, int const* argb);
+void simBlit(int x, int y, int w, int h, int const* argb, int stride);
 int simRand();
+void simRandFill(int* buffer, int n);
+// Records one sample of an app-defined metric for the SIM_STATS summary and CSV.
+// The name must stay valid until simExit
+void simMetric(char const* name, long long value);
+// Cache-line aligned, zero-filled memory that stays valid until simExit.
+// Backed by huge pages when SIM_HUGE_PAGES=1
+void* simAlloc(size_t size);
+// Grid size from SIM_GRID=<w>x<h>, or the logical framebuffer size when unset.
+// Also tells the drivers how far the viewport may move
+void simGridSize(int* w, int* h);
+// Grid cell shown in the top-left corner of the framebuffer. Starts at SIM_VIEWPORT=<x>,<y>
+// (the grid center when unset), is moved with the arrow keys and stays inside the grid
+void simViewport(int* x, int* y);
+// Registers the app grid of size bytes that *cells points to for SIM_CHECKPOINT. The pointer is
+// read at every checkpoint, so it may be swapped between generations. With SIM_RESTORE=<path>
+// *cells is replaced by the cells of that checkpoint and 1 is returned, in which case the app
+// must keep its starting state out of the grid
+int simCheckpointGrid(unsigned char** cells, size_t size);
 #endif
 
 extern void simInit();
-extern void app();
+// Draw into a w x h framebuffer that is scaled up to the window with nearest-neighbour filtering
+extern void simInitLogical(int w, int h);
 extern void simExit();
+
+// The app is driven through three entry points, so generations and frames can run at different
+// rates. appInit sets up the grid after simInitLogical
+extern void appInit();
+extern void appStep(int generations);
+// Draws the grid cells under the viewport whose top-left cell is (x, y), without flushing
+extern void appRender(int x, int y);
+// Steps and renders the app until SIM_GENERATIONS generations have run (forever when unset).
+// Every frame is SIM_GENERATIONS_PER_FRAME generations (1 by default) after the previous one,
+// and 0 steps without rendering at all
+extern void simRun(void (*step)(int generations), void (*render)(int x, int y));
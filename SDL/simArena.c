@@ -0,0 +1,103 @@
+#include "simCommon.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Bump allocator over anonymous mappings. Pages come zero-filled from the kernel and are only
+// committed when touched, so a 100k x 100k grid costs nothing until the app writes to it.
+// With SIM_HUGE_PAGES=1 chunks are mapped from the hugetlb pool when possible and otherwise
+// advised to be backed by transparent huge pages.
+
+#define CACHE_LINE_SIZE 64
+#define CHUNK_SIZE (64UL << 20)
+#define HUGE_PAGE_SIZE (2UL << 20)
+
+typedef struct ArenaChunk
+{
+    struct ArenaChunk* next;
+    size_t size;
+    size_t used;
+} ArenaChunk;
+
+// Keeps the first allocation of a chunk on its own cache line
+#define CHUNK_HEADER_SIZE                                                                          \
+    ((sizeof(ArenaChunk) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE)
+
+static ArenaChunk* Chunks = NULL;
+static int HugePages = 0;
+
+static size_t roundUp(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+static void* mapChunk(size_t size)
+{
+    void* memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (HugePages)
+    {
+        memory = mmap(
+            NULL,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+            -1,
+            0
+        );
+    }
+#endif
+    if (memory == MAP_FAILED)
+    {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+        if (memory != MAP_FAILED && HugePages)
+        {
+            madvise(memory, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    if (memory == MAP_FAILED)
+    {
+        fprintf(stderr, "[sim] Failed to map %zu bytes for the arena\n", size);
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+void simArenaInit()
+{
+    char const* hugePages = getenv("SIM_HUGE_PAGES");
+    HugePages = hugePages && strcmp(hugePages, "0") != 0;
+}
+
+void* simAlloc(size_t size)
+{
+    size = roundUp(size ? size : 1, CACHE_LINE_SIZE);
+    if (!Chunks || Chunks->size - Chunks->used < size)
+    {
+        size_t chunkSize = CHUNK_HEADER_SIZE + size;
+        chunkSize = roundUp(chunkSize < CHUNK_SIZE ? CHUNK_SIZE : chunkSize, HUGE_PAGE_SIZE);
+        ArenaChunk* chunk = (ArenaChunk*) mapChunk(chunkSize);
+        chunk->next = Chunks;
+        chunk->size = chunkSize;
+        chunk->used = CHUNK_HEADER_SIZE;
+        Chunks = chunk;
+    }
+
+    void* memory = (char*) Chunks + Chunks->used;
+    Chunks->used += size;
+    return memory;
+}
+
+void simArenaExit()
+{
+    while (Chunks)
+    {
+        ArenaChunk* next = Chunks->next;
+        munmap(Chunks, Chunks->size);
+        Chunks = next;
+    }
+}
@@ -0,0 +1,274 @@
+#include "simCheckpoint.h"
+#include "simCommon.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// With SIM_CHECKPOINT=<path> the grid registered through simCheckpointGrid is written to path
+// every SIM_CHECKPOINT_EVERY generations (1000 by default) and once more at simExit.
+// The file is written by a forked child whose copy-on-write view of memory is the snapshot,
+// so the step loop only pays for the fork. A checkpoint that comes due while the previous one
+// is still being written is skipped. The child writes <path>.tmp and renames it over path,
+// so a crash at any point leaves a complete checkpoint behind.
+// With SIM_RESTORE=<path> simCheckpointGrid maps the cells of that checkpoint privately in
+// place of the app grid, so restoring takes the same time for any grid size and the cells are
+// only read from the file once the app touches them.
+
+#define DEFAULT_CHECKPOINT_EVERY 1000
+
+static char const* CheckpointPath = NULL;
+static char* TemporaryPath = NULL;
+static long long CheckpointEvery = DEFAULT_CHECKPOINT_EVERY;
+static unsigned char** Cells = NULL;
+static size_t CellsSize = 0;
+static long long Generation = 0;
+static long long RestoredGeneration = 0;
+static long long CheckpointedGeneration = 0;
+static pid_t Writer = -1;
+static void* RestoredCells = NULL;
+
+static int writeAll(int fd, void const* data, size_t size, off_t offset)
+{
+    char const* bytes = (char const*) data;
+    while (size > 0)
+    {
+        ssize_t written = pwrite(fd, bytes, size, offset);
+        // A write that makes no progress would otherwise be retried forever
+        if (written == 0 || (written < 0 && errno != EINTR))
+        {
+            return 0;
+        }
+        if (written > 0)
+        {
+            bytes += written;
+            size -= written;
+            offset += written;
+        }
+    }
+    return 1;
+}
+
+// Runs in the writer child, so it only makes calls that are safe after a fork
+static int writeCheckpoint(SimCheckpointHeader const* header, unsigned char const* cells)
+{
+    int fd = open(TemporaryPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    int written = writeAll(fd, header, sizeof(*header), 0) &&
+                  writeAll(fd, cells, header->cellsSize, (off_t) header->cellsOffset) &&
+                  fsync(fd) == 0;
+    written = close(fd) == 0 && written;
+    return written && rename(TemporaryPath, CheckpointPath) == 0;
+}
+
+// Returns 0 while the previous checkpoint is still being written
+static int reapWriter(int wait)
+{
+    if (Writer < 0)
+    {
+        return 1;
+    }
+
+    int status = 0;
+    pid_t reaped;
+    do
+    {
+        reaped = waitpid(Writer, &status, wait ? 0 : WNOHANG);
+    } while (reaped < 0 && errno == EINTR);
+    if (reaped == 0)
+    {
+        return 0;
+    }
+
+    if (reaped < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+        fprintf(stderr, "[sim] Failed to write checkpoint '%s'\n", CheckpointPath);
+    }
+    Writer = -1;
+    return 1;
+}
+
+static void startCheckpoint()
+{
+    if (!reapWriter(0))
+    {
+        fprintf(
+            stderr,
+            "[sim] Skipped the checkpoint of generation %lld, the previous one is still being "
+            "written\n",
+            Generation
+        );
+        return;
+    }
+
+    SimCheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SIM_CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = SIM_CHECKPOINT_VERSION;
+    header.gridWidth = GridWidth;
+    header.gridHeight = GridHeight;
+    header.generation = Generation;
+    header.cellsOffset = sysconf(_SC_PAGESIZE);
+    header.cellsSize = CellsSize;
+    simRandSave(&header.randSeed, &header.randNextStream, header.randState);
+
+    pid_t writer = fork();
+    if (writer < 0)
+    {
+        fprintf(stderr, "[sim] Failed to start writing checkpoint '%s'\n", CheckpointPath);
+        return;
+    }
+    if (writer == 0)
+    {
+        _exit(writeCheckpoint(&header, *Cells) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    Writer = writer;
+    CheckpointedGeneration = Generation;
+}
+
+static void failRestore(char const* path, char const* reason)
+{
+    fprintf(stderr, "[sim] Cannot restore '%s': %s\n", path, reason);
+    exit(EXIT_FAILURE);
+}
+
+void simCheckpointInit()
+{
+    CheckpointPath = getenv("SIM_CHECKPOINT");
+    char const* every = getenv("SIM_CHECKPOINT_EVERY");
+    if (every)
+    {
+        char* end;
+        CheckpointEvery = strtoll(every, &end, 10);
+        if (end == every || *end != '\0' || CheckpointEvery <= 0)
+        {
+            fprintf(stderr, "[sim] Bad SIM_CHECKPOINT_EVERY '%s', expected generations\n", every);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (CheckpointPath)
+    {
+        TemporaryPath = (char*) malloc(strlen(CheckpointPath) + sizeof(".tmp"));
+        strcpy(TemporaryPath, CheckpointPath);
+        strcat(TemporaryPath, ".tmp");
+    }
+}
+
+int simCheckpointGrid(unsigned char** cells, size_t size)
+{
+    Cells = cells;
+    CellsSize = size;
+    char const* path = getenv("SIM_RESTORE");
+    if (!path)
+    {
+        return 0;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        failRestore(path, strerror(errno));
+    }
+    SimCheckpointHeader header;
+    struct stat file;
+    if (read(fd, &header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, SIM_CHECKPOINT_MAGIC, sizeof(header.magic)) != 0)
+    {
+        failRestore(path, "not a checkpoint");
+    }
+    if (header.version != SIM_CHECKPOINT_VERSION)
+    {
+        failRestore(path, "written by another version");
+    }
+    if (header.gridWidth != (uint32_t) GridWidth || header.gridHeight != (uint32_t) GridHeight)
+    {
+        fprintf(
+            stderr,
+            "[sim] Cannot restore '%s': it holds a %ux%u grid, set SIM_GRID=%ux%u\n",
+            path,
+            header.gridWidth,
+            header.gridHeight,
+            header.gridWidth,
+            header.gridHeight
+        );
+        exit(EXIT_FAILURE);
+    }
+    if (header.cellsSize != size)
+    {
+        failRestore(path, "written by an app with another grid layout");
+    }
+    if (fstat(fd, &file) != 0 || (uint64_t) file.st_size < header.cellsOffset + header.cellsSize)
+    {
+        failRestore(path, "truncated");
+    }
+
+    // A checkpoint from a machine with larger pages can only be mapped at a page boundary here,
+    // and is read into the app grid otherwise
+    if (header.cellsOffset % sysconf(_SC_PAGESIZE) == 0)
+    {
+        void* mapped =
+            mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) header.cellsOffset);
+        if (mapped == MAP_FAILED)
+        {
+            failRestore(path, strerror(errno));
+        }
+        RestoredCells = mapped;
+        *cells = (unsigned char*) mapped;
+    }
+    else if (pread(fd, *cells, size, (off_t) header.cellsOffset) != (ssize_t) size)
+    {
+        failRestore(path, "truncated");
+    }
+    close(fd);
+
+    simRandRestore(header.randSeed, header.randNextStream, header.randState);
+    Generation = (long long) header.generation;
+    RestoredGeneration = Generation;
+    CheckpointedGeneration = Generation;
+    fprintf(stderr, "[sim] Restored generation %lld from '%s'\n", Generation, path);
+    return 1;
+}
+
+long long simCheckpointGeneration()
+{
+    return RestoredGeneration;
+}
+
+void simCheckpointStep(long long generation)
+{
+    long long previous = Generation;
+    Generation = generation;
+    if (CheckpointPath && Cells && generation / CheckpointEvery != previous / CheckpointEvery)
+    {
+        startCheckpoint();
+    }
+}
+
+void simCheckpointExit()
+{
+    reapWriter(1);
+    if (CheckpointPath && Cells && Generation != CheckpointedGeneration)
+    {
+        startCheckpoint();
+        reapWriter(1);
+    }
+
+    // The restored mapping may have ended up as either grid of the app, which lives until now
+    if (RestoredCells)
+    {
+        munmap(RestoredCells, CellsSize);
+        RestoredCells = NULL;
+    }
+    free(TemporaryPath);
+    TemporaryPath = NULL;
+    Cells = NULL;
+}
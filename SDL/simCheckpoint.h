@@ -0,0 +1,30 @@
+#ifndef SIM_CHECKPOINT_H
+#define SIM_CHECKPOINT_H
+
+#include <stdint.h>
+
+// Checkpoint layout: a SimCheckpointHeader, zero padding up to cellsOffset and then cellsSize
+// bytes of the app grid exactly as it is laid out in memory. cellsOffset is a multiple of the
+// page size of the writer, so the cells can be mapped straight from the file on restore.
+// The random state is the one of the thread that called simInit.
+// The version changes whenever the meaning of any field changes.
+
+#define SIM_CHECKPOINT_MAGIC "SIMCKPT"
+#define SIM_CHECKPOINT_VERSION 1
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t gridWidth;
+    uint32_t gridHeight;
+    uint32_t reserved;
+    uint64_t generation;
+    uint64_t cellsOffset;
+    uint64_t cellsSize;
+    uint64_t randSeed;
+    uint64_t randNextStream;
+    uint64_t randState[4];
+} SimCheckpointHeader;
+
+#endif
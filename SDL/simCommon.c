@@ -0,0 +1,199 @@
+#include "simCommon.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Generations per step call when nothing is rendered, so the app still sees bounded calls
+#define UNRENDERED_GENERATIONS 1024
+
+uint32_t Framebuffer[SIM_Y_SIZE * SIM_X_SIZE];
+int FramebufferWidth = SIM_X_SIZE;
+int FramebufferHeight = SIM_Y_SIZE;
+
+int GridWidth = 0;
+int GridHeight = 0;
+static int ViewportX = 0;
+static int ViewportY = 0;
+static int ViewportRequested = 0;
+
+static void clampViewport()
+{
+    int maxX = GridWidth > FramebufferWidth ? GridWidth - FramebufferWidth : 0;
+    int maxY = GridHeight > FramebufferHeight ? GridHeight - FramebufferHeight : 0;
+    ViewportX = ViewportX < 0 ? 0 : ViewportX > maxX ? maxX : ViewportX;
+    ViewportY = ViewportY < 0 ? 0 : ViewportY > maxY ? maxY : ViewportY;
+}
+
+void simCommonInit(int width, int height)
+{
+    assert(0 < width && width <= SIM_X_SIZE && SIM_X_SIZE % width == 0 && "Bad logical width");
+    assert(0 < height && height <= SIM_Y_SIZE && SIM_Y_SIZE % height == 0 && "Bad logical height");
+    FramebufferWidth = width;
+    FramebufferHeight = height;
+    GridWidth = width;
+    GridHeight = height;
+    char const* viewport = getenv("SIM_VIEWPORT");
+    ViewportRequested = viewport && sscanf(viewport, "%d,%d", &ViewportX, &ViewportY) == 2;
+    simArenaInit();
+    simRandInit();
+    simRecorderInit();
+    simCheckpointInit();
+}
+
+void simCommonFlush()
+{
+    simStatsFlushBegin();
+    simRecorderAddFrame();
+}
+
+void simCommonFlushEnd()
+{
+    simStatsFlushEnd();
+}
+
+void simCommonExit()
+{
+    simCheckpointExit();
+    simStatsExit();
+    simRecorderExit();
+    simArenaExit();
+}
+
+void simGridSize(int* w, int* h)
+{
+    char const* grid = getenv("SIM_GRID");
+    if (grid && sscanf(grid, "%dx%d", &GridWidth, &GridHeight) != 2)
+    {
+        fprintf(stderr, "[sim] Unknown SIM_GRID '%s', expected <width>x<height>\n", grid);
+        exit(EXIT_FAILURE);
+    }
+    if (grid
+        && (GridWidth <= 0 || GridWidth > SIM_MAX_GRID_SIZE || GridHeight <= 0
+            || GridHeight > SIM_MAX_GRID_SIZE))
+    {
+        fprintf(
+            stderr,
+            "[sim] Bad SIM_GRID '%s', each side must be 1 to %d cells\n",
+            grid,
+            SIM_MAX_GRID_SIZE
+        );
+        exit(EXIT_FAILURE);
+    }
+
+    if (!ViewportRequested)
+    {
+        ViewportX = (GridWidth - FramebufferWidth) / 2;
+        ViewportY = (GridHeight - FramebufferHeight) / 2;
+    }
+    clampViewport();
+    *w = GridWidth;
+    *h = GridHeight;
+}
+
+void simViewport(int* x, int* y)
+{
+    *x = ViewportX;
+    *y = ViewportY;
+}
+
+void simMoveViewport(int dx, int dy)
+{
+    ViewportX += dx;
+    ViewportY += dy;
+    clampViewport();
+}
+
+void simRun(void (*step)(int generations), void (*render)(int x, int y))
+{
+    char const* limit = getenv("SIM_GENERATIONS");
+    char const* perFrame = getenv("SIM_GENERATIONS_PER_FRAME");
+    long long end = limit ? strtoll(limit, NULL, 10) : 0;
+    int forever = end <= 0;
+    int generationsPerFrame = perFrame ? atoi(perFrame) : 1;
+    assert(generationsPerFrame >= 0 && "Bad SIM_GENERATIONS_PER_FRAME");
+    // Without frames the drivers neither handle events nor count frames, so nothing would end
+    // the run
+    if (generationsPerFrame == 0 && forever)
+    {
+        fprintf(stderr, "[sim] SIM_GENERATIONS_PER_FRAME=0 needs SIM_GENERATIONS\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // A restored app carries on counting from its checkpoint, so SIM_GENERATIONS is where the
+    // run ends rather than how long it is
+    long long generation = simCheckpointGeneration();
+
+    // The frame shows the current generation before it is stepped, as the original app loop did
+    while (forever || generation < end)
+    {
+        int generations = UNRENDERED_GENERATIONS;
+        if (generationsPerFrame > 0)
+        {
+            int x, y;
+            simViewport(&x, &y);
+            render(x, y);
+            simFlush();
+            generations = generationsPerFrame;
+        }
+        if (!forever && generations > end - generation)
+        {
+            generations = (int) (end - generation);
+        }
+        step(generations);
+        generation += generations;
+        simCheckpointStep(generation);
+    }
+}
+
+void simPutPixel(int x, int y, int argb)
+{
+    assert(0 <= x && x < FramebufferWidth && "Out of range");
+    assert(0 <= y && y < FramebufferHeight && "Out of range");
+    Framebuffer[y * FramebufferWidth + x] = argb;
+    ++DrawCalls[SIM_DRAW_PUT_PIXEL];
+    ++PixelsDrawn;
+}
+
+void simFillRect(int x, int y, int w, int h, int argb)
+{
+    assert(0 <= x && 0 <= w && x + w <= FramebufferWidth && "Out of range");
+    assert(0 <= y && 0 <= h && y + h <= FramebufferHeight && "Out of range");
+    for (int row = y; row < y + h; ++row)
+    {
+        uint32_t* line = Framebuffer + row * FramebufferWidth + x;
+        for (int column = 0; column < w; ++column)
+        {
+            line[column] = argb;
+        }
+    }
+    ++DrawCalls[SIM_DRAW_FILL_RECT];
+    PixelsDrawn += w * h;
+}
+
+void simPutSpan(int x, int y, int len, int const* argb)
+{
+    assert(0 <= x && 0 <= len && x + len <= FramebufferWidth && "Out of range");
+    assert(0 <= y && y < FramebufferHeight && "Out of range");
+    memcpy(Framebuffer + y * FramebufferWidth + x, argb, len * sizeof(uint32_t));
+    ++DrawCalls[SIM_DRAW_PUT_SPAN];
+    PixelsDrawn += len;
+}
+
+void simBlit(int x, int y, int w, int h, int const* argb, int stride)
+{
+    assert(0 <= x && 0 <= w && x + w <= FramebufferWidth && "Out of range");
+    assert(0 <= y && 0 <= h && y + h <= FramebufferHeight && "Out of range");
+    assert(w <= stride && "Stride is shorter than a row");
+    for (int row = 0; row < h; ++row)
+    {
+        memcpy(
+            Framebuffer + (y + row) * FramebufferWidth + x,
+            argb + row * stride,
+            w * sizeof(uint32_t)
+        );
+    }
+    ++DrawCalls[SIM_DRAW_BLIT];
+    PixelsDrawn += w * h;
+}
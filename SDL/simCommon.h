@@ -0,0 +1,76 @@
+#ifndef SIM_COMMON_H
+#define SIM_COMMON_H
+
+#include "sim.h"
+
+#include <stdint.h>
+
+// State and helpers shared by every implementation of the sim.h interface
+
+typedef enum
+{
+    SIM_DRAW_PUT_PIXEL,
+    SIM_DRAW_FILL_RECT,
+    SIM_DRAW_PUT_SPAN,
+    SIM_DRAW_BLIT,
+    SIM_DRAW_CALL_COUNT,
+} SimDrawCall;
+
+typedef enum
+{
+    // Between the end of one simFlush and the start of the next one
+    SIM_TIMER_APP,
+    // Inside simFlush
+    SIM_TIMER_FLUSH,
+    // Backend-specific parts of showing a frame
+    SIM_TIMER_UPLOAD,
+    SIM_TIMER_PRESENT,
+    SIM_TIMER_SLEEP,
+    SIM_TIMER_COUNT,
+} SimTimer;
+
+// Only the first FramebufferWidth * FramebufferHeight pixels are used in logical mode
+extern uint32_t Framebuffer[SIM_Y_SIZE * SIM_X_SIZE];
+extern int FramebufferWidth;
+extern int FramebufferHeight;
+extern int GridWidth;
+extern int GridHeight;
+extern uint64_t DrawCalls[SIM_DRAW_CALL_COUNT];
+extern uint64_t PixelsDrawn;
+
+void simCommonInit(int width, int height);
+void simCommonFlush();
+void simCommonFlushEnd();
+void simCommonExit();
+
+uint64_t simNow();
+// Called by the backends once they are ready to show frames
+void simStatsInit();
+void simStatsRecord(SimTimer kind, uint64_t nanoseconds);
+void simStatsFlushBegin();
+void simStatsFlushEnd();
+void simStatsExit();
+
+// Moves the viewport by a number of cells, clamped to the grid
+void simMoveViewport(int dx, int dy);
+
+void simRandInit();
+// Stream state of the calling thread, and what the streams of new threads are derived from
+void simRandSave(uint64_t* seed, uint64_t* nextStream, uint64_t state[4]);
+void simRandRestore(uint64_t seed, uint64_t nextStream, uint64_t const state[4]);
+
+void simArenaInit();
+void simArenaExit();
+
+void simRecorderInit();
+void simRecorderAddFrame();
+void simRecorderExit();
+
+void simCheckpointInit();
+// Generation the app was restored at, 0 when it starts from scratch
+long long simCheckpointGeneration();
+// Called by simRun whenever generation generations have run in total
+void simCheckpointStep(long long generation);
+void simCheckpointExit();
+
+#endif
@@ -0,0 +1,174 @@
+#include "simCommon.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Renders into memory only, never sleeps. Configured through the environment:
+//   SIM_FRAME_LIMIT=N  exit after N flushed frames (0 or unset runs forever)
+//   SIM_DUMP_EVERY=N   print a checksum of every N-th frame to stderr
+//   SIM_DUMP_PPM=path  also write every dumped frame to <path><frame>.ppm
+
+static long FrameLimit = 0;
+static long DumpEvery = 0;
+static char const* DumpPpmPrefix = NULL;
+static long Frames = 0;
+static struct timespec StartTime;
+
+static long readEnvironmentNumber(char const* name)
+{
+    char const* value = getenv(name);
+    return value ? strtol(value, NULL, 10) : 0;
+}
+
+// Window-sized copy of the frame, so dumps do not depend on the logical size
+static uint32_t Upscaled[SIM_Y_SIZE * SIM_X_SIZE];
+
+static void expandRow(uint32_t const* source, uint32_t* destination, int scale)
+{
+#ifdef __SSE2__
+    if (scale % 4 == 0)
+    {
+        for (int x = 0; x < FramebufferWidth; ++x)
+        {
+            __m128i pixel = _mm_set1_epi32(source[x]);
+            for (int i = 0; i < scale; i += 4)
+            {
+                _mm_storeu_si128((__m128i*) (destination + x * scale + i), pixel);
+            }
+        }
+        return;
+    }
+#endif
+    for (int x = 0; x < FramebufferWidth; ++x)
+    {
+        for (int i = 0; i < scale; ++i)
+        {
+            destination[x * scale + i] = source[x];
+        }
+    }
+}
+
+static uint32_t const* upscaledFrame()
+{
+    if (FramebufferWidth == SIM_X_SIZE && FramebufferHeight == SIM_Y_SIZE)
+    {
+        return Framebuffer;
+    }
+
+    int scaleX = SIM_X_SIZE / FramebufferWidth;
+    int scaleY = SIM_Y_SIZE / FramebufferHeight;
+    for (int y = 0; y < FramebufferHeight; ++y)
+    {
+        uint32_t* row = Upscaled + y * scaleY * SIM_X_SIZE;
+        expandRow(Framebuffer + y * FramebufferWidth, row, scaleX);
+        for (int i = 1; i < scaleY; ++i)
+        {
+            memcpy(row + i * SIM_X_SIZE, row, SIM_X_SIZE * sizeof(uint32_t));
+        }
+    }
+    return Upscaled;
+}
+
+static uint64_t frameChecksum(uint32_t const* frame)
+{
+    // FNV-1a over whole pixels
+    uint64_t hash = 14695981039346656037ULL;
+    for (int i = 0; i < SIM_Y_SIZE * SIM_X_SIZE; ++i)
+    {
+        hash ^= frame[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void dumpPpm(uint32_t const* frame, long number)
+{
+    char filename[4096];
+    snprintf(filename, sizeof(filename), "%s%06ld.ppm", DumpPpmPrefix, number);
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        perror(filename);
+        return;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", SIM_X_SIZE, SIM_Y_SIZE);
+    unsigned char row[SIM_X_SIZE * 3];
+    for (int y = 0; y < SIM_Y_SIZE; ++y)
+    {
+        for (int x = 0; x < SIM_X_SIZE; ++x)
+        {
+            uint32_t argb = frame[y * SIM_X_SIZE + x];
+            row[x * 3] = (argb >> 16) & 0xFF;
+            row[x * 3 + 1] = (argb >> 8) & 0xFF;
+            row[x * 3 + 2] = argb & 0xFF;
+        }
+        fwrite(row, sizeof(row), 1, file);
+    }
+    fclose(file);
+}
+
+static double secondsSince(struct timespec const* start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+void simInit()
+{
+    simInitLogical(SIM_X_SIZE, SIM_Y_SIZE);
+}
+
+void simInitLogical(int w, int h)
+{
+    simCommonInit(w, h);
+    FrameLimit = readEnvironmentNumber("SIM_FRAME_LIMIT");
+    DumpEvery = readEnvironmentNumber("SIM_DUMP_EVERY");
+    DumpPpmPrefix = getenv("SIM_DUMP_PPM");
+    clock_gettime(CLOCK_MONOTONIC, &StartTime);
+    simStatsInit();
+}
+
+void simExit()
+{
+    simCommonExit();
+    double seconds = secondsSince(&StartTime);
+    fprintf(
+        stderr,
+        "[sim] %ld frames in %.3f s (%.1f frames/s)\n",
+        Frames,
+        seconds,
+        seconds > 0 ? Frames / seconds : 0.0
+    );
+}
+
+void simFlush()
+{
+    simCommonFlush();
+    ++Frames;
+
+    if (DumpEvery > 0 && Frames % DumpEvery == 0)
+    {
+        uint32_t const* frame = upscaledFrame();
+        fprintf(stderr, "[sim] frame %ld checksum %016" PRIx64 "\n", Frames, frameChecksum(frame));
+        if (DumpPpmPrefix)
+        {
+            dumpPpm(frame, Frames);
+        }
+    }
+    simCommonFlushEnd();
+
+    if (FrameLimit > 0 && Frames >= FrameLimit)
+    {
+        simExit();
+        exit(EXIT_SUCCESS);
+    }
+}
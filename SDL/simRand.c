@@ -0,0 +1,110 @@
+#include "simCommon.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef __cplusplus
+#define SIM_THREAD_LOCAL thread_local
+#else
+#define SIM_THREAD_LOCAL _Thread_local
+#endif
+
+// xoshiro256** with one independent stream per thread. Every stream is derived
+// from SIM_SEED (the current time when unset) and the order in which threads first
+// ask for random numbers, so the thread that calls simInit always gets stream 0.
+
+static uint64_t Seed = 0;
+static uint64_t NextStream = 0;
+static SIM_THREAD_LOCAL uint64_t State[4];
+static SIM_THREAD_LOCAL int StateSeeded = 0;
+
+static uint64_t splitMix64(uint64_t* x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotateLeft(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static void seedState()
+{
+    uint64_t stream = __atomic_fetch_add(&NextStream, 1, __ATOMIC_RELAXED);
+    uint64_t x = Seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; ++i)
+    {
+        State[i] = splitMix64(&x);
+    }
+    StateSeeded = 1;
+}
+
+static uint64_t nextRandom()
+{
+    uint64_t result = rotateLeft(State[1] * 5, 7) * 9;
+    uint64_t t = State[1] << 17;
+    State[2] ^= State[0];
+    State[3] ^= State[1];
+    State[1] ^= State[2];
+    State[0] ^= State[3];
+    State[2] ^= t;
+    State[3] = rotateLeft(State[3], 45);
+    return result;
+}
+
+void simRandInit()
+{
+    char const* seed = getenv("SIM_SEED");
+    Seed = seed ? strtoull(seed, NULL, 0) : (uint64_t) time(NULL);
+    NextStream = 0;
+    seedState();
+}
+
+int simRand()
+{
+    if (!StateSeeded)
+    {
+        seedState();
+    }
+    return nextRandom() >> 33;
+}
+
+void simRandFill(int* buffer, int n)
+{
+    if (!StateSeeded)
+    {
+        seedState();
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        buffer[i] = nextRandom() >> 33;
+    }
+}
+
+void simRandSave(uint64_t* seed, uint64_t* nextStream, uint64_t state[4])
+{
+    if (!StateSeeded)
+    {
+        seedState();
+    }
+    *seed = Seed;
+    *nextStream = NextStream;
+    for (int i = 0; i < 4; ++i)
+    {
+        state[i] = State[i];
+    }
+}
+
+void simRandRestore(uint64_t seed, uint64_t nextStream, uint64_t const state[4])
+{
+    Seed = seed;
+    NextStream = nextStream;
+    for (int i = 0; i < 4; ++i)
+    {
+        State[i] = state[i];
+    }
+    StateSeeded = 1;
+}
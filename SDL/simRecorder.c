@@ -0,0 +1,77 @@
+#include "simCommon.h"
+#include "simRecording.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Enabled by SIM_RECORD=path. Frames are encoded only when flushed,
+// so drawing calls do not pay anything for it.
+
+static FILE* Recording = NULL;
+static uint32_t PreviousFrame[SIM_Y_SIZE * SIM_X_SIZE];
+static SimRecordingRun Runs[SIM_Y_SIZE * SIM_X_SIZE];
+
+void simRecorderInit()
+{
+    char const* path = getenv("SIM_RECORD");
+    if (!path)
+    {
+        return;
+    }
+
+    Recording = fopen(path, "wb");
+    if (!Recording)
+    {
+        perror(path);
+        return;
+    }
+
+    SimRecordingHeader header;
+    memcpy(header.magic, SIM_RECORDING_MAGIC, sizeof(header.magic));
+    header.width = FramebufferWidth;
+    header.height = FramebufferHeight;
+    fwrite(&header, sizeof(header), 1, Recording);
+}
+
+void simRecorderAddFrame()
+{
+    if (!Recording)
+    {
+        return;
+    }
+
+    uint32_t runCount = 0;
+    uint32_t runValue = Framebuffer[0] ^ PreviousFrame[0];
+    uint32_t runLength = 0;
+    for (int i = 0; i < FramebufferWidth * FramebufferHeight; ++i)
+    {
+        uint32_t value = Framebuffer[i] ^ PreviousFrame[i];
+        if (value != runValue)
+        {
+            Runs[runCount].length = runLength;
+            Runs[runCount].value = runValue;
+            ++runCount;
+            runValue = value;
+            runLength = 0;
+        }
+        ++runLength;
+    }
+    Runs[runCount].length = runLength;
+    Runs[runCount].value = runValue;
+    ++runCount;
+
+    fwrite(&runCount, sizeof(runCount), 1, Recording);
+    fwrite(Runs, sizeof(SimRecordingRun), runCount, Recording);
+    fflush(Recording);
+    memcpy(PreviousFrame, Framebuffer, FramebufferWidth * FramebufferHeight * sizeof(uint32_t));
+}
+
+void simRecorderExit()
+{
+    if (Recording)
+    {
+        fclose(Recording);
+        Recording = NULL;
+    }
+}
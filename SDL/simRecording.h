@@ -0,0 +1,27 @@
+#ifndef SIM_RECORDING_H
+#define SIM_RECORDING_H
+
+#include <stdint.h>
+
+// Recording layout: a SimRecordingHeader followed by frames until the end of the file.
+// Each frame is a uint32_t run count followed by that many SimRecordingRun entries.
+// The runs cover the whole frame in row-major order and hold the XOR of every pixel
+// with the same pixel of the previous frame (the frame before the first one is all zeroes).
+// Runs are maximal, so equal frame sequences always produce equal encodings.
+
+#define SIM_RECORDING_MAGIC "SIMREC1"
+
+typedef struct
+{
+    char magic[8];
+    uint32_t width;
+    uint32_t height;
+} SimRecordingHeader;
+
+typedef struct
+{
+    uint32_t length;
+    uint32_t value;
+} SimRecordingRun;
+
+#endif
@@ -0,0 +1,274 @@
+#include "simCommon.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Enabled by SIM_STATS=1 (summary on stderr at simExit) and/or SIM_STATS_CSV=path
+// (CSV written at simExit and whenever the process receives SIGUSR1).
+// Each timer keeps a log2 histogram of nanoseconds, so percentiles are upper bounds
+// of power-of-two buckets. Metrics sampled by the app through simMetric are kept the same way
+// in their own units and follow the timers in the summary and the CSV.
+
+#define HISTOGRAM_BUCKETS 64
+#define MAX_METRICS 16
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint64_t histogram[HISTOGRAM_BUCKETS];
+} Timer;
+
+uint64_t DrawCalls[SIM_DRAW_CALL_COUNT];
+uint64_t PixelsDrawn = 0;
+
+static char const* const DrawCallNames[SIM_DRAW_CALL_COUNT] = {
+    "simPutPixel",
+    "simFillRect",
+    "simPutSpan",
+    "simBlit",
+};
+
+static char const* const TimerNames[SIM_TIMER_COUNT] = {
+    "app",
+    "flush",
+    "upload",
+    "present",
+    "sleep",
+};
+
+static Timer Timers[SIM_TIMER_COUNT];
+static Timer Metrics[MAX_METRICS];
+static char const* MetricNames[MAX_METRICS];
+static int MetricCount = 0;
+static uint64_t Frames = 0;
+static uint64_t LastFlushEnd = 0;
+static uint64_t FlushBegin = 0;
+static int PrintSummary = 0;
+static char const* CsvPath = NULL;
+static volatile sig_atomic_t CsvRequested = 0;
+
+static int bucketOf(uint64_t nanoseconds)
+{
+    int bucket = 0;
+    while (bucket < HISTOGRAM_BUCKETS - 1 && (nanoseconds >> bucket) > 1)
+    {
+        ++bucket;
+    }
+    return bucket;
+}
+
+static uint64_t percentile(Timer const* timer, double fraction)
+{
+    uint64_t threshold = (uint64_t) (timer->count * fraction);
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket)
+    {
+        seen += timer->histogram[bucket];
+        if (seen > threshold)
+        {
+            uint64_t bound = (uint64_t) 1 << (bucket + 1);
+            return bound < timer->max ? bound : timer->max;
+        }
+    }
+    return timer->max;
+}
+
+static void requestCsv(int signal)
+{
+    (void) signal;
+    CsvRequested = 1;
+}
+
+static void writeCsvRow(FILE* file, char const* name, Timer const* timer)
+{
+    fprintf(
+        file,
+        "%s,%llu,%llu,%llu,%llu,%llu,%llu\n",
+        name,
+        (unsigned long long) timer->count,
+        (unsigned long long) timer->total,
+        (unsigned long long) (timer->count ? timer->min : 0),
+        (unsigned long long) timer->max,
+        (unsigned long long) percentile(timer, 0.5),
+        (unsigned long long) percentile(timer, 0.99)
+    );
+}
+
+static void writeCsv()
+{
+    FILE* file = fopen(CsvPath, "w");
+    if (!file)
+    {
+        perror(CsvPath);
+        return;
+    }
+
+    fprintf(file, "metric,count,total_ns,min_ns,max_ns,p50_ns,p99_ns\n");
+    fprintf(file, "frames,%llu,,,,,\n", (unsigned long long) Frames);
+    fprintf(file, "pixels,%llu,,,,,\n", (unsigned long long) PixelsDrawn);
+    for (int call = 0; call < SIM_DRAW_CALL_COUNT; ++call)
+    {
+        fprintf(file, "%s,%llu,,,,,\n", DrawCallNames[call], (unsigned long long) DrawCalls[call]);
+    }
+    for (int kind = 0; kind < SIM_TIMER_COUNT; ++kind)
+    {
+        writeCsvRow(file, TimerNames[kind], &Timers[kind]);
+    }
+    for (int metric = 0; metric < MetricCount; ++metric)
+    {
+        writeCsvRow(file, MetricNames[metric], &Metrics[metric]);
+    }
+    fclose(file);
+}
+
+static void printSummary()
+{
+    fprintf(
+        stderr,
+        "[sim] %llu frames, %llu pixels drawn",
+        (unsigned long long) Frames,
+        (unsigned long long) PixelsDrawn
+    );
+    for (int call = 0; call < SIM_DRAW_CALL_COUNT; ++call)
+    {
+        fprintf(stderr, ", %llu %s", (unsigned long long) DrawCalls[call], DrawCallNames[call]);
+    }
+    fprintf(
+        stderr,
+        "\n[sim] %-8s %10s %10s %10s %10s\n",
+        "timer",
+        "total ms",
+        "mean us",
+        "p50 us",
+        "p99 us"
+    );
+    for (int kind = 0; kind < SIM_TIMER_COUNT; ++kind)
+    {
+        Timer const* timer = &Timers[kind];
+        if (timer->count == 0)
+        {
+            continue;
+        }
+        fprintf(
+            stderr,
+            "[sim] %-8s %10.1f %10.1f %10.1f %10.1f\n",
+            TimerNames[kind],
+            timer->total * 1e-6,
+            timer->total * 1e-3 / timer->count,
+            percentile(timer, 0.5) * 1e-3,
+            percentile(timer, 0.99) * 1e-3
+        );
+    }
+
+    if (MetricCount == 0)
+    {
+        return;
+    }
+    fprintf(stderr, "[sim] %-16s %10s %10s %10s %10s\n", "metric", "mean", "p50", "p99", "max");
+    for (int metric = 0; metric < MetricCount; ++metric)
+    {
+        Timer const* timer = &Metrics[metric];
+        fprintf(
+            stderr,
+            "[sim] %-16s %10.1f %10llu %10llu %10llu\n",
+            MetricNames[metric],
+            (double) timer->total / timer->count,
+            (unsigned long long) percentile(timer, 0.5),
+            (unsigned long long) percentile(timer, 0.99),
+            (unsigned long long) timer->max
+        );
+    }
+}
+
+uint64_t simNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void simStatsInit()
+{
+    char const* summary = getenv("SIM_STATS");
+    PrintSummary = summary && summary[0] && summary[0] != '0';
+    CsvPath = getenv("SIM_STATS_CSV");
+    if (CsvPath)
+    {
+        signal(SIGUSR1, requestCsv);
+    }
+    LastFlushEnd = simNow();
+}
+
+static void recordSample(Timer* timer, uint64_t value)
+{
+    if (timer->count == 0 || value < timer->min)
+    {
+        timer->min = value;
+    }
+    if (value > timer->max)
+    {
+        timer->max = value;
+    }
+    ++timer->count;
+    timer->total += value;
+    ++timer->histogram[bucketOf(value)];
+}
+
+void simStatsRecord(SimTimer kind, uint64_t nanoseconds)
+{
+    recordSample(&Timers[kind], nanoseconds);
+}
+
+void simMetric(char const* name, long long value)
+{
+    int metric = 0;
+    while (metric < MetricCount && strcmp(MetricNames[metric], name) != 0)
+    {
+        ++metric;
+    }
+    if (metric == MetricCount)
+    {
+        if (MetricCount == MAX_METRICS)
+        {
+            return;
+        }
+        MetricNames[MetricCount++] = name;
+    }
+    recordSample(&Metrics[metric], value > 0 ? (uint64_t) value : 0);
+}
+
+void simStatsFlushBegin()
+{
+    FlushBegin = simNow();
+    simStatsRecord(SIM_TIMER_APP, FlushBegin - LastFlushEnd);
+    ++Frames;
+    if (CsvRequested)
+    {
+        CsvRequested = 0;
+        writeCsv();
+    }
+}
+
+void simStatsFlushEnd()
+{
+    LastFlushEnd = simNow();
+    simStatsRecord(SIM_TIMER_FLUSH, LastFlushEnd - FlushBegin);
+}
+
+void simStatsExit()
+{
+    if (PrintSummary)
+    {
+        printSummary();
+    }
+    if (CsvPath)
+    {
+        writeCsv();
+    }
+}
@@ -2,8 +2,9 @@
 
 int main(void)
 {
-    simInit();
-    app();
+    simInitLogical(SIM_X_SIZE / SIM_ZOOM, SIM_Y_SIZE / SIM_ZOOM);
+    appInit();
+    simRun(appStep, appRender);
     simExit();
     return 0;
 }